@@ -1,5 +1,21 @@
 #include "s21_matrix.h"
 
+#include <float.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void mult_into(matrix_t *A, matrix_t *B, matrix_t *result);
+static void cofactor_terms(matrix_t *A, double *terms);
+static void complements_into(matrix_t *A, matrix_t *result);
+static void alloc_block(matrix_t *A);
+static void free_block(matrix_t *A);
+
 /**
  * @brief Создает нулевую матрицу размерности rows * columns.
  *
@@ -11,9 +27,12 @@ int s21_create_matrix(int rows, int columns, matrix_t *result) {
   if (rows > 0 && columns > 0) {
     result->rows = rows;
     result->columns = columns;
+    result->block = NULL;
+    result->hashed = 0;
     result->matrix = (double **)calloc(rows, sizeof(double *));
     if (result->matrix) {
-      for (rows--; rows >= 0 && mem_flg; rows--) {
+      alloc_block(result);
+      for (rows--; !result->block && rows >= 0 && mem_flg; rows--) {
         result->matrix[rows] = (double *)calloc(columns, sizeof(double));
         if (!result->matrix[rows]) mem_flg = 0;
       }
@@ -29,7 +48,8 @@ int s21_create_matrix(int rows, int columns, matrix_t *result) {
  * @param A matrix_t type
  */
 void s21_remove_matrix(matrix_t *A) {
-  for (int i = 0; i < A->rows; i++) {
+  if (A->block) free_block(A);
+  for (int i = 0; i < A->rows && A->matrix; i++) {
     if (A->matrix[i]) {
         free(A->matrix[i]);
         A->matrix[i] = NULL;
@@ -39,20 +59,123 @@ void s21_remove_matrix(matrix_t *A) {
   A->matrix = NULL;
   A->columns = 0;
   A->rows = 0;
+  A->hashed = 0;
 }
 
 /**
- * @brief Возвращает результат сравнения матриц A и B.
+ * @brief Расстояние между a и b в ULP (единицах последнего разряда).
+ *
+ * @return uint64_t количество представимых double между a и b
+ */
+static uint64_t ulp_distance(double a, double b) {
+  int64_t ia, ib;
+  memcpy(&ia, &a, sizeof(ia));
+  memcpy(&ib, &b, sizeof(ib));
+  if (ia < 0) ia = INT64_MIN - ia;
+  if (ib < 0) ib = INT64_MIN - ib;
+  return ia > ib ? (uint64_t)ia - (uint64_t)ib : (uint64_t)ib - (uint64_t)ia;
+}
+
+/**
+ * @brief Внутренний режим для s21_eq_matrix: |a - b| <= EPS, где NaN, как и
+ * раньше, не считается расхождением.
+ *
+ */
+enum { EQ_LEGACY = EQ_ULP + 1 };
+
+/**
+ * @brief Точная поэлементная проверка блока [begin, end): элементы равны,
+ * если a == b или |a - b| укладывается в допуск. NaN не равен ничему,
+ * бесконечности равны только бесконечностям того же знака.
+ *
+ * @return int 1, если в блоке есть расхождение
+ */
+static int block_differs(const double *a, const double *b, int begin,
+                         int end, int mode, double tolerance) {
+  int diff = 0;
+  for (int j = begin; j < end && !diff; j++) {
+    if (mode == EQ_ULP) {
+      diff = isnan(a[j]) || isnan(b[j]) ||
+             (double)ulp_distance(a[j], b[j]) > tolerance;
+    } else {
+      double t = mode == EQ_RELATIVE
+                     ? tolerance * fmax(fabs(a[j]), fabs(b[j]))
+                     : tolerance;
+      diff = !(a[j] == b[j] ||
+               (isfinite(a[j]) && isfinite(b[j]) && fabs(a[j] - b[j]) <= t));
+    }
+  }
+  return diff;
+}
+
+/**
+ * @brief Сравнивает строки a и b длины n блоками по S21_EQ_BLOCK
+ * элементов, выход - после первого блока с расхождением. В режимах
+ * EQ_ABSOLUTE и EQ_RELATIVE блок просматривается без ветвлений: в четырех
+ * дорожках копится максимум |a - b| - t и признак того, что разность
+ * бесконечна или NaN. Модуль ограничен DBL_MAX, чтобы 0 * inf не давал
+ * NaN в абсолютном режиме. Такой цикл векторизуется; блок с
+ * бесконечностями или NaN перепроверяется точно в block_differs. Режим
+ * EQ_ULP считается скалярно (64-битные целые не векторизуются на SSE2).
  *
  * @return int SUCCESS/FAILURE
  */
-int s21_eq_matrix(matrix_t *A, matrix_t *B) {
+static int rows_equal(const double *restrict a, const double *restrict b,
+                      int n, int mode, double tolerance) {
+  int res = SUCCESS;
+  double tol_rel = mode == EQ_RELATIVE ? tolerance : 0.0;
+  double tol_abs = mode == EQ_RELATIVE ? 0.0 : tolerance;
+  for (int begin = 0; begin < n && res == SUCCESS; begin += S21_EQ_BLOCK) {
+    int end = n - begin > S21_EQ_BLOCK ? begin + S21_EQ_BLOCK : n;
+    int diff = 0;
+    if (mode == EQ_ULP) {
+      diff = block_differs(a, b, begin, end, mode, tolerance);
+    } else {
+      double w[4] = {0.0, 0.0, 0.0, 0.0}, z[4] = {0.0, 0.0, 0.0, 0.0};
+      int j = begin;
+      for (; j + 4 <= end; j += 4) {
+        for (int l = 0; l < 4; l++) {
+          double x = a[j + l], y = b[j + l];
+          double ax = fabs(x), ay = fabs(y);
+          double m = ax > ay ? ax : ay;
+          m = m < DBL_MAX ? m : DBL_MAX;
+          double e = fabs(x - y) - (tol_abs + tol_rel * m);
+          w[l] = e > w[l] ? e : w[l];
+          z[l] += (x - y) * 0.0;
+        }
+      }
+      for (; j < end; j++) {
+        double m = fmin(fmax(fabs(a[j]), fabs(b[j])), DBL_MAX);
+        double t = tol_abs + tol_rel * m;
+        double e = fabs(a[j] - b[j]) - t;
+        w[0] = e > w[0] ? e : w[0];
+        z[0] += (a[j] - b[j]) * 0.0;
+      }
+      if (mode != EQ_LEGACY && (z[0] + z[1]) + (z[2] + z[3]) != 0.0) {
+        diff = block_differs(a, b, begin, end, mode, tolerance);
+      } else {
+        diff = w[0] > 0.0 || w[1] > 0.0 || w[2] > 0.0 || w[3] > 0.0;
+      }
+    }
+    if (diff) res = FAILURE;
+  }
+  return res;
+}
+
+/**
+ * @brief Сравнение матриц A и B построчно в режиме mode.
+ *
+ * @return int SUCCESS/FAILURE
+ */
+static int eq_matrix(matrix_t *A, matrix_t *B, int mode, double tolerance) {
   int res = SUCCESS;
   if (!check_matrix(A) && !check_matrix(B) && !matrix_size_eq(A, B)) {
-    for (int i = 0; i < A->rows; i++) {
-      for (int j = 0; j < A->columns; j++) {
-        if (fabs(A->matrix[i][j] - B->matrix[i][j]) > EPS) {
-          res = FAILURE;
+    if (!(tolerance > 0.0)) tolerance = 0.0;
+    if (A->matrix != B->matrix) {
+      for (int i = 0; i < A->rows && res == SUCCESS; i++) {
+        if (A->matrix[i] != B->matrix[i]) {
+          res = rows_equal(A->matrix[i], B->matrix[i], A->columns, mode,
+                           tolerance);
         }
       }
     }
@@ -62,6 +185,107 @@ int s21_eq_matrix(matrix_t *A, matrix_t *B) {
   return res;
 }
 
+/**
+ * @brief Сравнение матриц A и B с заданным допуском. Режимы: EQ_ABSOLUTE
+ * (|a - b| <= tolerance), EQ_RELATIVE (|a - b| <= tolerance * max(|a|, |b|))
+ * и EQ_ULP (не более tolerance представимых double между a и b).
+ * NaN не равен ничему, бесконечности равны только бесконечностям того же
+ * знака. Одна и та же матрица (или общие строки) не просматривается.
+ *
+ * @return int SUCCESS/FAILURE
+ */
+int s21_eq_matrix_tol(matrix_t *A, matrix_t *B, int mode, double tolerance) {
+  int res = FAILURE;
+  if (mode >= EQ_ABSOLUTE && mode <= EQ_ULP) {
+    res = eq_matrix(A, B, mode, tolerance);
+  }
+  return res;
+}
+
+/**
+ * @brief Возвращает результат сравнения матриц A и B.
+ *
+ * @return int SUCCESS/FAILURE
+ */
+int s21_eq_matrix(matrix_t *A, matrix_t *B) {
+  return eq_matrix(A, B, EQ_LEGACY, EPS);
+}
+
+/**
+ * @brief Хеш содержимого матрицы A (размеры и битовое представление
+ * элементов). Хеш записывается в result и сохраняется в A->hash
+ * (A->hashed = 1), после чего s21_eq_matrix_hash сравнивает матрицу без
+ * чтения данных. Библиотека не отслеживает запись в элементы: после любого
+ * изменения A->matrix нужно обнулить A->hashed или посчитать хеш заново.
+ * Для сравнения с допуском используйте s21_eq_matrix_tol.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_matrix_hash(matrix_t *A, unsigned long long *result) {
+  int res = OK;
+  if (!check_matrix(A) && result) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = (hash ^ (uint64_t)A->rows) * 0x100000001b3ull;
+    hash = (hash ^ (uint64_t)A->columns) * 0x100000001b3ull;
+    for (int i = 0; i < A->rows; i++) {
+      uint64_t lanes[4] = {hash, hash + 1, hash + 2, hash + 3};
+      int j = 0;
+      for (; j + 4 <= A->columns; j += 4) {
+        for (int l = 0; l < 4; l++) {
+          uint64_t bits;
+          memcpy(&bits, &A->matrix[i][j + l], sizeof(bits));
+          lanes[l] = (lanes[l] ^ bits) * 0x9e3779b97f4a7c15ull;
+          lanes[l] ^= lanes[l] >> 29;
+        }
+      }
+      for (; j < A->columns; j++) {
+        uint64_t bits;
+        memcpy(&bits, &A->matrix[i][j], sizeof(bits));
+        lanes[0] = (lanes[0] ^ bits) * 0x9e3779b97f4a7c15ull;
+        lanes[0] ^= lanes[0] >> 29;
+      }
+      for (int l = 0; l < 4; l++) hash = (hash ^ lanes[l]) * 0x100000001b3ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    *result = hash;
+    A->hash = hash;
+    A->hashed = 1;
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Побитовое сравнение матриц A и B (то же равенство, что проверяет
+ * хеш: +0.0 и -0.0 различны, одинаковые NaN равны). Если хеши посчитаны у
+ * обеих матриц, сравниваются только размеры и хеши: совпадение означает
+ * побитово равные матрицы с вероятностью коллизии 2^-64. Иначе строки
+ * сравниваются через memcmp. Сохраненный хеш не следит за изменениями
+ * элементов: после любой записи в матрицу нужно сбросить hashed или
+ * посчитать хеш заново.
+ *
+ * @return int SUCCESS/FAILURE
+ */
+int s21_eq_matrix_hash(matrix_t *A, matrix_t *B) {
+  int res = FAILURE;
+  if (!check_matrix(A) && !check_matrix(B) && !matrix_size_eq(A, B)) {
+    if (A->hashed && B->hashed) {
+      res = A->hash == B->hash ? SUCCESS : FAILURE;
+    } else {
+      res = SUCCESS;
+      for (int i = 0; i < A->rows && res == SUCCESS; i++) {
+        if (memcmp(A->matrix[i], B->matrix[i], A->columns * sizeof(double))) {
+          res = FAILURE;
+        }
+      }
+    }
+  }
+  return res;
+}
+
 /**
  * @brief Cложения матриц A и B.
  *
@@ -146,15 +370,7 @@ int s21_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
   if (!check_matrix(A) && !check_matrix(B)) {
     if (A->columns == B->rows) {
       res = s21_create_matrix(A->rows, B->columns, result);
-      if (!res) {
-        for (int i = 0; i < A->rows; i++) {
-          for (int j = 0; j < B->columns; j++) {
-            for (int k = 0; k < B->rows; k++) {
-              result->matrix[i][j] += A->matrix[i][k] * B->matrix[k][j];
-            }
-          }
-        }
-      }
+      if (!res) mult_into(A, B, result);
     } else {
       res = CALCULATION_ERROR;
     }
@@ -196,18 +412,8 @@ int s21_calc_complements(matrix_t *A, matrix_t *result) {
   int res = OK;
 if (!check_matrix(A)) {
     if (A->rows == A->columns && A->rows > 1) {
-      s21_create_matrix(A->rows, A->rows, result);
-      for (int i = 0; i < A->rows; i++) {
-        for (int j = 0; j < A->rows; j++) {
-          double determinant = 0.0;
-          matrix_t minor;
-          s21_create_matrix(A->rows - 1, A->rows - 1, &minor);
-          get_minor(A, &minor, i, j);
-          s21_determinant(&minor, &determinant);
-          result->matrix[i][j] = pow(-1, i + j) * determinant;
-          s21_remove_matrix(&minor);
-        }
-      }
+      res = s21_create_matrix(A->rows, A->rows, result);
+      if (!res) complements_into(A, result);
     } else {
       res = INCORRECT_MATRIX;
     }
@@ -229,20 +435,20 @@ int s21_determinant(matrix_t *A, double *result) {
           if (A->rows == 1) {
               *result = A->matrix[0][0];
           } else {
-            for (int i = 0; i < A->rows; i++) {
-              double determinant = 0.0;
-              matrix_t minor;
-              s21_create_matrix(A->rows - 1, A->rows - 1, &minor);
-              get_minor(A, &minor, i, 0);
-              s21_determinant(&minor, &determinant);
-              determinant *= A->matrix[i][0];
-              if (i % 2) {
-                *result -= determinant;
-              } else {
-                *result += determinant;
+            double *terms = (double *)calloc(A->rows, sizeof(double));
+            if (terms) {
+              cofactor_terms(A, terms);
+              for (int i = 0; i < A->rows; i++) {
+                if (i % 2) {
+                  *result -= terms[i];
+                } else {
+                  *result += terms[i];
+                }
               }
-              s21_remove_matrix(&minor);
+            } else {
+              res = INCORRECT_MATRIX;
             }
+            free(terms);
           }
       } else {
         res = CALCULATION_ERROR;
@@ -330,3 +536,2754 @@ int matrix_size_eq(matrix_t *A, matrix_t *B) {
   return err;
 }
 
+
+static pthread_once_t threads_once = PTHREAD_ONCE_INIT;
+static int threads_total = 1;
+
+static void init_thread_count(void) {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  char *env = getenv("S21_MATRIX_THREADS");
+  if (env && atoi(env) > 0) count = atoi(env);
+  if (count < 1) count = 1;
+  if (count > S21_MAX_THREADS) count = S21_MAX_THREADS;
+  threads_total = (int)count;
+}
+
+/**
+ * @brief Количество потоков для параллельных ядер. Берется из переменной
+ * окружения S21_MATRIX_THREADS, иначе равно числу доступных ядер.
+ *
+ * @return int количество потоков
+ */
+static int thread_count(void) {
+  pthread_once(&threads_once, init_thread_count);
+  return threads_total;
+}
+
+typedef struct task {
+  void (*fn)(void *arg);
+  void *arg;
+  atomic_int *pending;
+} task_t;
+
+typedef struct deque {
+  pthread_mutex_t lock;
+  task_t **items;
+  int head;
+  int tail;
+  int capacity;
+} deque_t;
+
+/**
+ * @brief Планировщик с перехватом работы (work stealing). У каждого рабочего
+ * потока своя очередь: владелец кладет и берет задачи с конца (LIFO), чужие
+ * потоки крадут с начала (FIFO). Задачи от внешних потоков попадают в общую
+ * очередь deques[S21_MAX_THREADS].
+ */
+static struct scheduler {
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_t tid[S21_MAX_THREADS];
+  deque_t deques[S21_MAX_THREADS + 1];
+  int workers;
+  int started;
+  int stop;
+  atomic_int queued;
+} sched = {.lock = PTHREAD_MUTEX_INITIALIZER,
+           .wake = PTHREAD_COND_INITIALIZER};
+
+static _Thread_local int worker_id = -1;
+
+static int deque_push(deque_t *deque, task_t *task) {
+  int res = OK;
+  pthread_mutex_lock(&deque->lock);
+  if (deque->tail == deque->capacity && deque->head > 0) {
+    memmove(deque->items, deque->items + deque->head,
+            (deque->tail - deque->head) * sizeof(task_t *));
+    deque->tail -= deque->head;
+    deque->head = 0;
+  }
+  if (deque->tail == deque->capacity) {
+    int capacity = deque->capacity ? deque->capacity * 2 : 64;
+    task_t **items =
+        (task_t **)realloc(deque->items, capacity * sizeof(task_t *));
+    if (items) {
+      deque->items = items;
+      deque->capacity = capacity;
+    } else {
+      res = INCORRECT_MATRIX;
+    }
+  }
+  if (!res) deque->items[deque->tail++] = task;
+  pthread_mutex_unlock(&deque->lock);
+  return res;
+}
+
+static task_t *deque_take(deque_t *deque, int steal) {
+  task_t *task = NULL;
+  pthread_mutex_lock(&deque->lock);
+  if (deque->tail > deque->head) {
+    task = steal ? deque->items[deque->head++] : deque->items[--deque->tail];
+  }
+  if (deque->tail == deque->head) deque->head = deque->tail = 0;
+  pthread_mutex_unlock(&deque->lock);
+  return task;
+}
+
+/**
+ * @brief Забирает из очереди первую задачу со счетчиком pending, сохраняя
+ * порядок остальных задач.
+ *
+ * @return task_t* задача или NULL
+ */
+static task_t *deque_take_matching(deque_t *deque, atomic_int *pending) {
+  task_t *task = NULL;
+  pthread_mutex_lock(&deque->lock);
+  for (int i = deque->head; !task && i < deque->tail; i++) {
+    if (deque->items[i]->pending == pending) {
+      task = deque->items[i];
+      memmove(deque->items + i, deque->items + i + 1,
+              (deque->tail - i - 1) * sizeof(task_t *));
+      deque->tail--;
+    }
+  }
+  if (deque->tail == deque->head) deque->head = deque->tail = 0;
+  pthread_mutex_unlock(&deque->lock);
+  return task;
+}
+
+/**
+ * @brief Берет задачу: сначала из своей очереди, затем из общей, затем
+ * крадет у остальных рабочих потоков.
+ *
+ * @return task_t* задача или NULL
+ */
+static task_t *take_task(void) {
+  task_t *task = NULL;
+  if (atomic_load(&sched.queued) > 0) {
+    if (worker_id >= 0) task = deque_take(&sched.deques[worker_id], 0);
+    if (!task) task = deque_take(&sched.deques[S21_MAX_THREADS], 1);
+    for (int i = 1; !task && i <= sched.workers; i++) {
+      int victim = ((worker_id < 0 ? 0 : worker_id) + i) % sched.workers;
+      task = deque_take(&sched.deques[victim], 1);
+    }
+    if (task) atomic_fetch_sub(&sched.queued, 1);
+  }
+  return task;
+}
+
+static void run_task(task_t *task) {
+  atomic_int *pending = task->pending;
+  task->fn(task->arg);
+  if (pending) atomic_fetch_sub(pending, 1);
+}
+
+static void *worker_main(void *arg) {
+  worker_id = (int)(intptr_t)arg;
+  int stop = 0;
+  while (!stop) {
+    task_t *task = take_task();
+    if (task) {
+      run_task(task);
+    } else {
+      pthread_mutex_lock(&sched.lock);
+      while (!sched.stop && atomic_load(&sched.queued) == 0) {
+        pthread_cond_wait(&sched.wake, &sched.lock);
+      }
+      stop = sched.stop && atomic_load(&sched.queued) == 0;
+      pthread_mutex_unlock(&sched.lock);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Закрепляет рабочие потоки за процессорами: поток i - за i-м
+ * процессором из маски процесса. Так кусок t из parallel_for всегда
+ * считается на одном и том же ядре (и узле NUMA), и страницы, заполненные
+ * в touch_rows, оказываются локальными для потока, который с ними
+ * работает. Если потоков больше, чем процессоров, закрепление не делается.
+ *
+ */
+static void pin_workers(void) {
+  cpu_set_t allowed;
+  if (!sched_getaffinity(0, sizeof(allowed), &allowed) &&
+      sched.workers <= CPU_COUNT(&allowed)) {
+    int worker = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && worker < sched.workers; cpu++) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        pthread_setaffinity_np(sched.tid[worker++], sizeof(one), &one);
+      }
+    }
+  }
+}
+
+static void start_scheduler(void) {
+  pthread_mutex_lock(&sched.lock);
+  if (!sched.started) {
+    int count = thread_count();
+    for (int i = 0; i <= S21_MAX_THREADS; i++) {
+      pthread_mutex_init(&sched.deques[i].lock, NULL);
+    }
+    sched.workers = 0;
+    sched.stop = 0;
+    for (int i = 0; i < count; i++) {
+      if (!pthread_create(&sched.tid[sched.workers], NULL, worker_main,
+                          (void *)(intptr_t)sched.workers)) {
+        sched.workers++;
+      }
+    }
+    pin_workers();
+    sched.started = 1;
+  }
+  pthread_mutex_unlock(&sched.lock);
+}
+
+/**
+ * @brief Ставит задачу в очередь рабочего потока worker (при worker < 0 - в
+ * общую очередь). Если задача попала в чужую очередь, будятся все потоки,
+ * чтобы владелец взял ее сам, а не отдал на кражу. Если очередь
+ * недоступна, задача выполняется сразу в текущем потоке.
+ *
+ */
+static void submit_task_to(task_t *task, int worker) {
+  start_scheduler();
+  deque_t *deque = &sched.deques[worker >= 0 ? worker : S21_MAX_THREADS];
+  if (sched.workers && !deque_push(deque, task)) {
+    pthread_mutex_lock(&sched.lock);
+    atomic_fetch_add(&sched.queued, 1);
+    if (worker >= 0 && worker != worker_id) {
+      pthread_cond_broadcast(&sched.wake);
+    } else {
+      pthread_cond_signal(&sched.wake);
+    }
+    pthread_mutex_unlock(&sched.lock);
+  } else {
+    run_task(task);
+  }
+}
+
+/**
+ * @brief Ставит задачу в очередь текущего рабочего потока или, для
+ * внешнего потока, в общую очередь.
+ *
+ */
+static void submit_task(task_t *task) { submit_task_to(task, worker_id); }
+
+/**
+ * @brief Ждет, пока *pending не станет нулем, выполняя в это время задачи
+ * из очередей, чтобы ожидание внутри рабочего потока не блокировало ядро.
+ * Внешний поток забирает из общей очереди только свои куски (с тем же
+ * pending): иначе синхронный вызов мог бы выполнять чужие асинхронные
+ * операции целиком.
+ *
+ */
+static void help_until(atomic_int *pending) {
+  while (atomic_load(pending) > 0) {
+    task_t *task = NULL;
+    if (worker_id >= 0) {
+      task = take_task();
+    } else if (atomic_load(&sched.queued) > 0) {
+      task = deque_take_matching(&sched.deques[S21_MAX_THREADS], pending);
+      if (task) atomic_fetch_sub(&sched.queued, 1);
+    }
+    if (task) {
+      run_task(task);
+    } else {
+      sched_yield();
+    }
+  }
+}
+
+/**
+ * @brief Останавливает рабочие потоки планировщика после выполнения всех
+ * поставленных задач. При следующей асинхронной или параллельной операции
+ * планировщик запускается снова.
+ *
+ */
+void s21_scheduler_shutdown(void) {
+  pthread_mutex_lock(&sched.lock);
+  int started = sched.started;
+  sched.stop = 1;
+  pthread_cond_broadcast(&sched.wake);
+  pthread_mutex_unlock(&sched.lock);
+  for (int i = 0; started && i < sched.workers; i++) {
+    pthread_join(sched.tid[i], NULL);
+  }
+  pthread_mutex_lock(&sched.lock);
+  for (int i = 0; started && i <= S21_MAX_THREADS; i++) {
+    free(sched.deques[i].items);
+    pthread_mutex_destroy(&sched.deques[i].lock);
+    sched.deques[i] = (deque_t){0};
+  }
+  sched.workers = 0;
+  sched.started = 0;
+  sched.stop = 0;
+  pthread_mutex_unlock(&sched.lock);
+}
+
+typedef void (*range_fn)(void *ctx, int begin, int end);
+
+typedef struct range_task {
+  task_t task;
+  range_fn fn;
+  void *ctx;
+  int begin;
+  int end;
+} range_task_t;
+
+static void run_range(void *arg) {
+  range_task_t *range = (range_task_t *)arg;
+  range->fn(range->ctx, range->begin, range->end);
+}
+
+/**
+ * @brief Делит диапазон [0, n) на непрерывные куски и выполняет fn над ними
+ * на планировщике. Если вызывающий поток внешний, кусок t ставится в
+ * очередь рабочего потока t, а вызывающий только ждет: при одинаковых n
+ * кусок t каждый раз считается закрепленным потоком t, поэтому строки,
+ * заполненные в touch_rows, остаются на его узле NUMA (свободный поток
+ * может украсть кусок, если владелец занят). Внутри рабочего потока куски
+ * ставятся в свою очередь, а первый кусок выполняется на месте. Если объем
+ * работы work (в элементах) меньше S21_PARALLEL_THRESHOLD, выполняется в
+ * текущем потоке.
+ *
+ */
+static void parallel_for(int n, long work, range_fn fn, void *ctx) {
+  int threads = work < S21_PARALLEL_THRESHOLD ? 1 : thread_count();
+  if (threads > n) threads = n;
+  if (threads > 1) start_scheduler();
+  if (threads <= 1) {
+    fn(ctx, 0, n);
+  } else if (worker_id < 0 && sched.workers >= threads) {
+    range_task_t range[S21_MAX_THREADS];
+    atomic_int pending = threads;
+    for (int t = 0; t < threads; t++) {
+      range[t] = (range_task_t){{run_range, &range[t], &pending},
+                                fn,
+                                ctx,
+                                (int)((long)n * t / threads),
+                                (int)((long)n * (t + 1) / threads)};
+      submit_task_to(&range[t].task, t);
+    }
+    help_until(&pending);
+  } else {
+    range_task_t range[S21_MAX_THREADS];
+    atomic_int pending = threads - 1;
+    for (int t = 1; t < threads; t++) {
+      range[t] = (range_task_t){{run_range, &range[t], &pending},
+                                fn,
+                                ctx,
+                                (int)((long)n * t / threads),
+                                (int)((long)n * (t + 1) / threads)};
+      submit_task(&range[t].task);
+    }
+    fn(ctx, 0, (int)((long)n / threads));
+    help_until(&pending);
+  }
+}
+
+/**
+ * @brief Скалярное произведение с четырьмя независимыми аккумуляторами,
+ * чтобы компилятор мог векторизовать цикл без -ffast-math.
+ *
+ * @return double x * y
+ */
+static double dot_kernel(const double *restrict x, const double *restrict y,
+                         int n) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += x[i] * y[i];
+    s1 += x[i + 1] * y[i + 1];
+    s2 += x[i + 2] * y[i + 2];
+    s3 += x[i + 3] * y[i + 3];
+  }
+  for (; i < n; i++) s0 += x[i] * y[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * @brief Максимальный модуль элемента x. Четыре независимых максимума в
+ * массиве позволяют векторизовать тело цикла.
+ *
+ * @return double max |x[i]|
+ */
+static double max_abs_kernel(const double *x, int n) {
+  double m[4] = {0.0, 0.0, 0.0, 0.0};
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (int l = 0; l < 4; l++) {
+      double a = fabs(x[i + l]);
+      m[l] = a > m[l] ? a : m[l];
+    }
+  }
+  for (; i < n; i++) m[0] = fabs(x[i]) > m[0] ? fabs(x[i]) : m[0];
+  m[0] = m[1] > m[0] ? m[1] : m[0];
+  m[2] = m[3] > m[2] ? m[3] : m[2];
+  return m[2] > m[0] ? m[2] : m[0];
+}
+
+/**
+ * @brief Сумма квадратов (scale * x[i]).
+ *
+ * @return double sum (scale * x[i])^2
+ */
+static double scaled_squares_kernel(const double *x, int n, double scale) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    double y0 = scale * x[i], y1 = scale * x[i + 1];
+    double y2 = scale * x[i + 2], y3 = scale * x[i + 3];
+    s0 += y0 * y0;
+    s1 += y1 * y1;
+    s2 += y2 * y2;
+    s3 += y3 * y3;
+  }
+  for (; i < n; i++) s0 += (scale * x[i]) * (scale * x[i]);
+  return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * @brief Сумма квадратов squares могла переполниться или потерять точность
+ * в субнормальных числах, и норму нужно пересчитать с масштабированием.
+ *
+ */
+static int needs_scaling(double squares) {
+  return isinf(squares) || squares < DBL_MIN / DBL_EPSILON;
+}
+
+/**
+ * @brief Масштаб для нормы с максимальным модулем элемента max: степень
+ * двойки 2^-e, при которой max * 2^-e лежит в [0.5, 1). Умножение на
+ * степень двойки точное, поэтому масштабирование не вносит ошибок.
+ *
+ */
+static double norm_scale(double max, int *e) {
+  frexp(max, e);
+  return ldexp(1.0, -*e);
+}
+
+/**
+ * @brief y[begin..end) += alpha * x[begin..end). Тело развернуто на четыре
+ * элемента: при -O2 GCC векторизует только циклы без эпилога, а развернутое
+ * тело векторизуется целиком.
+ *
+ */
+static void axpy_kernel(double alpha, const double *restrict x,
+                        double *restrict y, int begin, int end) {
+  int i = begin;
+  for (; i + 4 <= end; i += 4) {
+    y[i] += alpha * x[i];
+    y[i + 1] += alpha * x[i + 1];
+    y[i + 2] += alpha * x[i + 2];
+    y[i + 3] += alpha * x[i + 3];
+  }
+  for (; i < end; i++) y[i] += alpha * x[i];
+}
+
+typedef struct gemv_ctx {
+  matrix_t *A;
+  double *x;
+  double *y;
+} gemv_ctx_t;
+
+static void gemv_rows(void *arg, int begin, int end) {
+  gemv_ctx_t *ctx = (gemv_ctx_t *)arg;
+  for (int i = begin; i < end; i++) {
+    ctx->y[i] = dot_kernel(ctx->A->matrix[i], ctx->x, ctx->A->columns);
+  }
+}
+
+static void gemv_t_columns(void *arg, int begin, int end) {
+  gemv_ctx_t *ctx = (gemv_ctx_t *)arg;
+  for (int j = begin; j < end; j++) ctx->y[j] = 0.0;
+  for (int i = 0; i < ctx->A->rows; i++) {
+    axpy_kernel(ctx->x[i], ctx->A->matrix[i], ctx->y, begin, end);
+  }
+}
+
+/**
+ * @brief Умножение матрицы A на вектор x (длины A->columns).
+ * Результат записывается в result (длины A->rows).
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_mult_vector(matrix_t *A, double *x, double *result) {
+  int res = OK;
+  if (!check_matrix(A) && x && result) {
+    gemv_ctx_t ctx = {A, x, result};
+    parallel_for(A->rows, (long)A->rows * A->columns, gemv_rows, &ctx);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Умножение вектора x (длины A->rows) на матрицу A слева, то есть
+ * A^T * x. Результат записывается в result (длины A->columns).
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_mult_vector_transpose(matrix_t *A, double *x, double *result) {
+  int res = OK;
+  if (!check_matrix(A) && x && result) {
+    gemv_ctx_t ctx = {A, x, result};
+    parallel_for(A->columns, (long)A->rows * A->columns, gemv_t_columns,
+                 &ctx);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Скалярное произведение векторов x и y длины size.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_dot(double *x, double *y, int size, double *result) {
+  int res = OK;
+  if (x && y && result && size > 0) {
+    *result = dot_kernel(x, y, size);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Евклидова норма вектора x длины size. Сначала считается обычная
+ * сумма квадратов; если она переполнилась или ушла в субнормальные числа,
+ * норма пересчитывается по элементам, отмасштабированным по максимальному
+ * модулю, как в dnrm2.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_norm(double *x, int size, double *result) {
+  int res = s21_dot(x, x, size, result);
+  if (!res && needs_scaling(*result)) {
+    double max = max_abs_kernel(x, size);
+    if (max > 0.0 && isfinite(max)) {
+      int e = 0;
+      double scale = norm_scale(max, &e);
+      *result = ldexp(sqrt(scaled_squares_kernel(x, size, scale)), e);
+    } else {
+      *result = max;
+    }
+  } else if (!res) {
+    *result = sqrt(*result);
+  }
+  return res;
+}
+
+static int check_matrix_f(matrix_f_t *A) {
+  int err = INCORRECT_MATRIX;
+  if ((A != NULL) && (A->matrix != NULL) && (A->rows > 0) &&
+      (A->columns > 0)) {
+    err = OK;
+  }
+  return err;
+}
+
+/**
+ * @brief Создает нулевую float-матрицу размерности rows * columns.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_create_matrix_f(int rows, int columns, matrix_f_t *result) {
+  int mem_flg = 1;
+  int res = INCORRECT_MATRIX;
+  if (rows > 0 && columns > 0) {
+    result->rows = rows;
+    result->columns = columns;
+    result->matrix = (float **)calloc(rows, sizeof(float *));
+    if (result->matrix) {
+      for (rows--; rows >= 0 && mem_flg; rows--) {
+        result->matrix[rows] = (float *)calloc(columns, sizeof(float));
+        if (!result->matrix[rows]) mem_flg = 0;
+      }
+    }
+    if (mem_flg && result->matrix) res = OK;
+  }
+  return res;
+}
+
+/**
+ * @brief Очищает float-матрицу A
+ *
+ */
+void s21_remove_matrix_f(matrix_f_t *A) {
+  if (A->matrix) {
+    for (int i = 0; i < A->rows; i++) free(A->matrix[i]);
+    free(A->matrix);
+  }
+  A->matrix = NULL;
+  A->columns = 0;
+  A->rows = 0;
+}
+
+/**
+ * @brief Сложение float-матриц A и B.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_sum_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A) && !check_matrix_f(B)) {
+    if (A->rows == B->rows && A->columns == B->columns) {
+      res = s21_create_matrix_f(A->rows, A->columns, result);
+      for (int i = 0; !res && i < A->rows; i++) {
+        for (int j = 0; j < A->columns; j++) {
+          result->matrix[i][j] = A->matrix[i][j] + B->matrix[i][j];
+        }
+      }
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Вычитание float-матриц A и B.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_sub_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A) && !check_matrix_f(B)) {
+    if (A->rows == B->rows && A->columns == B->columns) {
+      res = s21_create_matrix_f(A->rows, A->columns, result);
+      for (int i = 0; !res && i < A->rows; i++) {
+        for (int j = 0; j < A->columns; j++) {
+          result->matrix[i][j] = A->matrix[i][j] - B->matrix[i][j];
+        }
+      }
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Умножение float-матрицы A на число number.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_mult_number_f(matrix_f_t *A, float number, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A)) {
+    res = s21_create_matrix_f(A->rows, A->columns, result);
+    for (int i = 0; !res && i < A->rows; i++) {
+      for (int j = 0; j < A->columns; j++) {
+        result->matrix[i][j] = A->matrix[i][j] * number;
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief y[0..n) += alpha * x[0..n). Тело развернуто на восемь элементов,
+ * то есть на два SSE-вектора float, чтобы цикл векторизовался при -O2.
+ *
+ */
+static void axpy_kernel_f(float alpha, const float *restrict x,
+                          float *restrict y, int n) {
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    y[i] += alpha * x[i];
+    y[i + 1] += alpha * x[i + 1];
+    y[i + 2] += alpha * x[i + 2];
+    y[i + 3] += alpha * x[i + 3];
+    y[i + 4] += alpha * x[i + 4];
+    y[i + 5] += alpha * x[i + 5];
+    y[i + 6] += alpha * x[i + 6];
+    y[i + 7] += alpha * x[i + 7];
+  }
+  for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+/**
+ * @brief Умножение float-матриц A и B. Порядок циклов i-k-j, чтобы
+ * внутренний цикл шел по строкам подряд и векторизовался.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_mult_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A) && !check_matrix_f(B)) {
+    if (A->columns == B->rows) {
+      res = s21_create_matrix_f(A->rows, B->columns, result);
+      for (int i = 0; !res && i < A->rows; i++) {
+        float *restrict c = result->matrix[i];
+        for (int k = 0; k < B->rows; k++) {
+          axpy_kernel_f(A->matrix[i][k], B->matrix[k], c, B->columns);
+        }
+      }
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Транспонирование float-матрицы A.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_transpose_f(matrix_f_t *A, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A)) {
+    res = s21_create_matrix_f(A->columns, A->rows, result);
+    for (int i = 0; !res && i < A->rows; i++) {
+      for (int j = 0; j < A->columns; j++) {
+        result->matrix[j][i] = A->matrix[i][j];
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Копирует double-матрицу A во float-матрицу result.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_convert_to_f(matrix_t *A, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix(A)) {
+    res = s21_create_matrix_f(A->rows, A->columns, result);
+    for (int i = 0; !res && i < A->rows; i++) {
+      for (int j = 0; j < A->columns; j++) {
+        result->matrix[i][j] = (float)A->matrix[i][j];
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Копирует float-матрицу A в double-матрицу result.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_convert_from_f(matrix_f_t *A, matrix_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A)) {
+    res = s21_create_matrix(A->rows, A->columns, result);
+    for (int i = 0; !res && i < A->rows; i++) {
+      for (int j = 0; j < A->columns; j++) {
+        result->matrix[i][j] = A->matrix[i][j];
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief LU-разложение квадратной матрицы LU на месте с выбором ведущего
+ * элемента по столбцу. Перестановки строк делаются обменом указателей и
+ * записываются в perm, знак перестановки - в sign. Ведущий элемент
+ * считается нулевым, если |p| <= tolerance * max |a_ij|: для решения систем
+ * передается DBL_EPSILON, для определителя - 0 (только точный ноль).
+ *
+ * @return int OK/CALCULATION_ERROR (матрица вырождена)
+ */
+static int lu_decompose(matrix_t *LU, int *perm, int *sign,
+                        double tolerance) {
+  int res = OK;
+  int n = LU->rows;
+  double scale = 0.0;
+  for (int i = 0; i < n; i++) {
+    perm[i] = i;
+    for (int j = 0; j < n; j++) scale = fmax(scale, fabs(LU->matrix[i][j]));
+  }
+  *sign = 1;
+  for (int k = 0; k < n && !res; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++) {
+      if (fabs(LU->matrix[i][k]) > fabs(LU->matrix[p][k])) p = i;
+    }
+    if (fabs(LU->matrix[p][k]) <= tolerance * scale) {
+      res = CALCULATION_ERROR;
+    } else {
+      if (p != k) {
+        double *row = LU->matrix[p];
+        LU->matrix[p] = LU->matrix[k];
+        LU->matrix[k] = row;
+        int idx = perm[p];
+        perm[p] = perm[k];
+        perm[k] = idx;
+        *sign = -*sign;
+      }
+      const double *restrict pivot_row = LU->matrix[k];
+      for (int i = k + 1; i < n; i++) {
+        double *restrict row = LU->matrix[i];
+        double l = row[k] / pivot_row[k];
+        row[k] = l;
+        for (int j = k + 1; j < n; j++) row[j] -= l * pivot_row[j];
+      }
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Решает LU * x = P * b по результату lu_decompose.
+ *
+ */
+static void lu_solve(matrix_t *LU, int *perm, double *b, double *x) {
+  int n = LU->rows;
+  for (int i = 0; i < n; i++) {
+    double sum = b[perm[i]];
+    for (int j = 0; j < i; j++) sum -= LU->matrix[i][j] * x[j];
+    x[i] = sum;
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    double sum = x[i];
+    for (int j = i + 1; j < n; j++) sum -= LU->matrix[i][j] * x[j];
+    x[i] = sum / LU->matrix[i][i];
+  }
+}
+
+/**
+ * @brief Float-версия lu_decompose; для решения систем передается
+ * FLT_EPSILON, для определителя - 0.
+ *
+ * @return int OK/CALCULATION_ERROR (матрица вырождена)
+ */
+static int lu_decompose_f(matrix_f_t *LU, int *perm, int *sign,
+                          float tolerance) {
+  int res = OK;
+  int n = LU->rows;
+  float scale = 0.0f;
+  for (int i = 0; i < n; i++) {
+    perm[i] = i;
+    for (int j = 0; j < n; j++) scale = fmaxf(scale, fabsf(LU->matrix[i][j]));
+  }
+  *sign = 1;
+  for (int k = 0; k < n && !res; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++) {
+      if (fabsf(LU->matrix[i][k]) > fabsf(LU->matrix[p][k])) p = i;
+    }
+    if (fabsf(LU->matrix[p][k]) <= tolerance * scale) {
+      res = CALCULATION_ERROR;
+    } else {
+      if (p != k) {
+        float *row = LU->matrix[p];
+        LU->matrix[p] = LU->matrix[k];
+        LU->matrix[k] = row;
+        int idx = perm[p];
+        perm[p] = perm[k];
+        perm[k] = idx;
+        *sign = -*sign;
+      }
+      const float *restrict pivot_row = LU->matrix[k];
+      for (int i = k + 1; i < n; i++) {
+        float *restrict row = LU->matrix[i];
+        float l = row[k] / pivot_row[k];
+        row[k] = l;
+        for (int j = k + 1; j < n; j++) row[j] -= l * pivot_row[j];
+      }
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Float-версия lu_solve.
+ *
+ */
+static void lu_solve_f(matrix_f_t *LU, int *perm, float *b, float *x) {
+  int n = LU->rows;
+  for (int i = 0; i < n; i++) {
+    float sum = b[perm[i]];
+    for (int j = 0; j < i; j++) sum -= LU->matrix[i][j] * x[j];
+    x[i] = sum;
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    float sum = x[i];
+    for (int j = i + 1; j < n; j++) sum -= LU->matrix[i][j] * x[j];
+    x[i] = sum / LU->matrix[i][i];
+  }
+}
+
+/**
+ * @brief Копия матрицы A в result.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int copy_matrix(matrix_t *A, matrix_t *result) {
+  int res = s21_create_matrix(A->rows, A->columns, result);
+  for (int i = 0; !res && i < A->rows; i++) {
+    memcpy(result->matrix[i], A->matrix[i], A->columns * sizeof(double));
+  }
+  return res;
+}
+
+/**
+ * @brief Решение системы A * X = B LU-разложением в double. Размеры A и B
+ * должны быть уже проверены.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR (матрица вырождена)
+ */
+static int lu_solve_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+  int n = A->rows, sign = 1;
+  matrix_t LU = {0};
+  int *perm = (int *)calloc(n, sizeof(int));
+  double *b = (double *)calloc(n, sizeof(double));
+  double *x = (double *)calloc(n, sizeof(double));
+  int res = perm && b && x ? copy_matrix(A, &LU) : INCORRECT_MATRIX;
+  if (!res) res = lu_decompose(&LU, perm, &sign, DBL_EPSILON);
+  if (!res) res = s21_create_matrix(n, B->columns, result);
+  for (int c = 0; !res && c < B->columns; c++) {
+    for (int i = 0; i < n; i++) b[i] = B->matrix[i][c];
+    lu_solve(&LU, perm, b, x);
+    for (int i = 0; i < n; i++) result->matrix[i][c] = x[i];
+  }
+  s21_remove_matrix(&LU);
+  free(perm);
+  free(b);
+  free(x);
+  return res;
+}
+
+/**
+ * @brief Обратная матрица квадратной A через LU-разложение в double.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR (матрица вырождена)
+ */
+static int lu_inverse(matrix_t *A, matrix_t *result) {
+  matrix_t identity = {0};
+  int res = s21_create_matrix(A->rows, A->rows, &identity);
+  for (int i = 0; !res && i < A->rows; i++) identity.matrix[i][i] = 1.0;
+  if (!res) res = lu_solve_matrix(A, &identity, result);
+  s21_remove_matrix(&identity);
+  return res;
+}
+
+/**
+ * @brief Копия float-матрицы A в result.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int copy_matrix_f(matrix_f_t *A, matrix_f_t *result) {
+  int res = s21_create_matrix_f(A->rows, A->columns, result);
+  for (int i = 0; !res && i < A->rows; i++) {
+    memcpy(result->matrix[i], A->matrix[i], A->columns * sizeof(float));
+  }
+  return res;
+}
+
+/**
+ * @brief Определитель float-матрицы A - произведение ведущих элементов
+ * LU-разложения. Ноль возвращается только при точно нулевом ведущем
+ * элементе.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_determinant_f(matrix_f_t *A, float *result) {
+  int res = OK;
+  if (!check_matrix_f(A)) {
+    if (A->rows == A->columns) {
+      matrix_f_t LU = {0};
+      int *perm = (int *)calloc(A->rows, sizeof(int));
+      int sign = 1;
+      res = perm ? copy_matrix_f(A, &LU) : INCORRECT_MATRIX;
+      if (!res) {
+        *result = 0.0f;
+        if (!lu_decompose_f(&LU, perm, &sign, 0.0f)) {
+          *result = (float)sign;
+          for (int i = 0; i < A->rows; i++) *result *= LU.matrix[i][i];
+        }
+      }
+      s21_remove_matrix_f(&LU);
+      free(perm);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Обратная float-матрица A через LU-разложение.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_inverse_matrix_f(matrix_f_t *A, matrix_f_t *result) {
+  int res = OK;
+  if (!check_matrix_f(A)) {
+    if (A->rows == A->columns) {
+      int n = A->rows;
+      matrix_f_t LU = {0};
+      int *perm = (int *)calloc(n, sizeof(int));
+      float *e = (float *)calloc(n, sizeof(float));
+      float *x = (float *)calloc(n, sizeof(float));
+      int sign = 1;
+      res = perm && e && x ? copy_matrix_f(A, &LU) : INCORRECT_MATRIX;
+      if (!res) res = lu_decompose_f(&LU, perm, &sign, FLT_EPSILON);
+      if (!res) res = s21_create_matrix_f(n, n, result);
+      for (int j = 0; !res && j < n; j++) {
+        e[j] = 1.0f;
+        lu_solve_f(&LU, perm, e, x);
+        e[j] = 0.0f;
+        for (int i = 0; i < n; i++) result->matrix[i][j] = x[i];
+      }
+      s21_remove_matrix_f(&LU);
+      free(perm);
+      free(e);
+      free(x);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Решение системы A * X = B со смешанной точностью: LU-разложение
+ * делается во float, затем решение уточняется итерациями с невязкой,
+ * посчитанной в double. Если уточнение не сходится (плохо обусловленная
+ * матрица), система решается LU-разложением в double.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_solve_mixed(matrix_t *A, matrix_t *B, matrix_t *result) {
+  int res = OK;
+  if (!check_matrix(A) && !check_matrix(B)) {
+    if (A->rows == A->columns && A->rows == B->rows) {
+      int n = A->rows, sign = 1;
+      matrix_f_t LU = {0};
+      int *perm = (int *)calloc(n, sizeof(int));
+      double *b = (double *)calloc(n, sizeof(double));
+      double *x = (double *)calloc(n, sizeof(double));
+      double *r = (double *)calloc(n, sizeof(double));
+      float *rf = (float *)calloc(n, sizeof(float));
+      float *df = (float *)calloc(n, sizeof(float));
+      int converged = 1;
+      res = perm && b && x && r && rf && df ? s21_convert_to_f(A, &LU)
+                                            : INCORRECT_MATRIX;
+      if (!res && lu_decompose_f(&LU, perm, &sign, FLT_EPSILON)) {
+        converged = 0;
+      }
+      if (!res) res = s21_create_matrix(n, B->columns, result);
+      double norm_a = 0.0;
+      for (int i = 0; !res && i < n; i++) {
+        double row_sum = 0.0;
+        for (int j = 0; j < n; j++) row_sum += fabs(A->matrix[i][j]);
+        norm_a = fmax(norm_a, row_sum);
+      }
+      for (int c = 0; !res && converged && c < B->columns; c++) {
+        double norm_b = 0.0;
+        for (int i = 0; i < n; i++) {
+          b[i] = B->matrix[i][c];
+          rf[i] = (float)b[i];
+          norm_b = fmax(norm_b, fabs(b[i]));
+        }
+        lu_solve_f(&LU, perm, rf, df);
+        for (int i = 0; i < n; i++) x[i] = df[i];
+        int done = 0;
+        for (int it = 0; it < S21_REFINE_ITERS && !done; it++) {
+          double norm_r = 0.0, norm_x = 0.0;
+          for (int i = 0; i < n; i++) {
+            r[i] = b[i] - dot_kernel(A->matrix[i], x, n);
+            norm_r = fmax(norm_r, fabs(r[i]));
+            norm_x = fmax(norm_x, fabs(x[i]));
+            rf[i] = (float)r[i];
+          }
+          if (norm_r <= DBL_EPSILON * sqrt(n) * (norm_a * norm_x + norm_b)) {
+            done = 1;
+          } else {
+            lu_solve_f(&LU, perm, rf, df);
+            for (int i = 0; i < n; i++) x[i] += df[i];
+          }
+        }
+        converged = done;
+        for (int i = 0; i < n; i++) result->matrix[i][c] = x[i];
+      }
+      if (!res && !converged) {
+        s21_remove_matrix(result);
+        res = lu_solve_matrix(A, B, result);
+      }
+      s21_remove_matrix_f(&LU);
+      free(perm);
+      free(b);
+      free(x);
+      free(r);
+      free(rf);
+      free(df);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Обратная матрица A со смешанной точностью (см. s21_solve_mixed).
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_inverse_matrix_mixed(matrix_t *A, matrix_t *result) {
+  int res = OK;
+  if (!check_matrix(A)) {
+    if (A->rows == A->columns) {
+      matrix_t identity = {0};
+      res = s21_create_matrix(A->rows, A->rows, &identity);
+      for (int i = 0; !res && i < A->rows; i++) identity.matrix[i][i] = 1.0;
+      if (!res) res = s21_solve_mixed(A, &identity, result);
+      s21_remove_matrix(&identity);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+typedef struct woodbury_ctx {
+  matrix_t *inverse;
+  matrix_t *W;
+  matrix_t *Y;
+  matrix_t *result;
+} woodbury_ctx_t;
+
+static void woodbury_rows(void *arg, int begin, int end) {
+  woodbury_ctx_t *ctx = (woodbury_ctx_t *)arg;
+  int n = ctx->inverse->columns;
+  for (int i = begin; i < end; i++) {
+    memcpy(ctx->result->matrix[i], ctx->inverse->matrix[i], n * sizeof(double));
+    for (int r = 0; r < ctx->Y->rows; r++) {
+      axpy_kernel(-ctx->W->matrix[i][r], ctx->Y->matrix[r],
+                  ctx->result->matrix[i], 0, n);
+    }
+  }
+}
+
+/**
+ * @brief Обновление обратной матрицы и определителя по формуле
+ * Шермана-Моррисона-Вудбери. По inverse = A^-1 и determinant = det(A)
+ * вычисляет обратную матрицу и определитель для A + U * V^T, где U и V
+ * размерности n * k. Сложность O(n^2 * k).
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR (размеры не
+ * согласованы или обновленная матрица вырождена)
+ */
+int s21_inverse_update(matrix_t *inverse, double determinant, matrix_t *U,
+                       matrix_t *V, matrix_t *result, double *result_det) {
+  int res = OK;
+  if (!check_matrix(inverse) && !check_matrix(U) && !check_matrix(V)) {
+    int n = inverse->rows, k = U->columns;
+    if (inverse->columns == n && U->rows == n && !matrix_size_eq(U, V)) {
+      matrix_t W = {0}, Y = {0}, C = {0};
+      int *perm = (int *)calloc(k, sizeof(int));
+      double *z = (double *)calloc(k, sizeof(double));
+      double *y = (double *)calloc(k, sizeof(double));
+      int sign = 1;
+      res = perm && z && y ? s21_mult_matrix(inverse, U, &W) : INCORRECT_MATRIX;
+      if (!res) res = s21_create_matrix(k, n, &Y);
+      for (int l = 0; !res && l < n; l++) {
+        for (int r = 0; r < k; r++) {
+          axpy_kernel(V->matrix[l][r], inverse->matrix[l], Y.matrix[r], 0, n);
+        }
+      }
+      if (!res) res = s21_create_matrix(k, k, &C);
+      for (int r = 0; !res && r < k; r++) {
+        C.matrix[r][r] = 1.0;
+        for (int l = 0; l < n; l++) {
+          axpy_kernel(V->matrix[l][r], W.matrix[l], C.matrix[r], 0, k);
+        }
+      }
+      if (!res) res = lu_decompose(&C, perm, &sign, DBL_EPSILON);
+      double det_c = sign;
+      for (int r = 0; !res && r < k; r++) det_c *= C.matrix[r][r];
+      if (!res && fabs(det_c) <= EPS) res = CALCULATION_ERROR;
+      for (int j = 0; !res && j < n; j++) {
+        for (int r = 0; r < k; r++) z[r] = Y.matrix[r][j];
+        lu_solve(&C, perm, z, y);
+        for (int r = 0; r < k; r++) Y.matrix[r][j] = y[r];
+      }
+      if (!res) res = s21_create_matrix(n, n, result);
+      if (!res) {
+        woodbury_ctx_t ctx = {inverse, &W, &Y, result};
+        parallel_for(n, (long)n * n * k, woodbury_rows, &ctx);
+        *result_det = determinant * det_c;
+      }
+      s21_remove_matrix(&W);
+      s21_remove_matrix(&Y);
+      s21_remove_matrix(&C);
+      free(perm);
+      free(z);
+      free(y);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Обновление ранга 1 по формуле Шермана-Моррисона: обратная матрица
+ * и определитель для A + u * v^T, где u и v - векторы длины n. Замена
+ * строки i на новую строку r - это u = e_i, v = r - A[i].
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR (обновленная матрица
+ * вырождена)
+ */
+int s21_inverse_update_rank1(matrix_t *inverse, double determinant, double *u,
+                             double *v, matrix_t *result, double *result_det) {
+  int res = OK;
+  if (!check_matrix(inverse) && u && v) {
+    if (inverse->rows == inverse->columns) {
+      int n = inverse->rows;
+      double *w = (double *)calloc(n, sizeof(double));
+      double *z = (double *)calloc(n, sizeof(double));
+      res = w && z ? s21_mult_vector(inverse, u, w) : INCORRECT_MATRIX;
+      if (!res) res = s21_mult_vector_transpose(inverse, v, z);
+      double c = 0.0;
+      if (!res) c = 1.0 + dot_kernel(v, w, n);
+      if (!res && fabs(c) <= EPS) res = CALCULATION_ERROR;
+      if (!res) res = s21_create_matrix(n, n, result);
+      for (int i = 0; !res && i < n; i++) {
+        memcpy(result->matrix[i], inverse->matrix[i], n * sizeof(double));
+        axpy_kernel(-w[i] / c, z, result->matrix[i], 0, n);
+      }
+      if (!res) *result_det = determinant * c;
+      free(w);
+      free(z);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+typedef struct mult_ctx {
+  matrix_t *A;
+  matrix_t *B;
+  matrix_t *result;
+} mult_ctx_t;
+
+static void mult_rows(void *arg, int begin, int end) {
+  mult_ctx_t *ctx = (mult_ctx_t *)arg;
+  int columns = ctx->B->columns;
+  for (int i = begin; i < end; i++) {
+    double *c = ctx->result->matrix[i];
+    memset(c, 0, columns * sizeof(double));
+    for (int k = 0; k < ctx->B->rows; k++) {
+      axpy_kernel(ctx->A->matrix[i][k], ctx->B->matrix[k], c, 0, columns);
+    }
+  }
+}
+
+typedef struct cofactor_ctx {
+  matrix_t *A;
+  matrix_t *result;
+  double *terms;
+} cofactor_ctx_t;
+
+/**
+ * @brief Оценка объема работы разложения по строке для матрицы n * n
+ * (n!), ограниченная сверху S21_PARALLEL_THRESHOLD.
+ *
+ */
+static long cofactor_work(int n) {
+  long work = 1;
+  for (int k = 2; k <= n && work < S21_PARALLEL_THRESHOLD; k++) work *= k;
+  return work;
+}
+
+static void cofactor_rows(void *arg, int begin, int end) {
+  cofactor_ctx_t *ctx = (cofactor_ctx_t *)arg;
+  matrix_t *A = ctx->A;
+  for (int i = begin; i < end; i++) {
+    double determinant = 0.0;
+    matrix_t minor;
+    s21_create_matrix(A->rows - 1, A->rows - 1, &minor);
+    get_minor(A, &minor, i, 0);
+    s21_determinant(&minor, &determinant);
+    ctx->terms[i] = determinant * A->matrix[i][0];
+    s21_remove_matrix(&minor);
+  }
+}
+
+/**
+ * @brief Слагаемые разложения определителя A по первому столбцу (без
+ * знака). Слагаемые считаются параллельно на планировщике, а складываются
+ * вызывающим кодом по порядку, поэтому определитель не зависит от числа
+ * потоков.
+ *
+ */
+static void cofactor_terms(matrix_t *A, double *terms) {
+  cofactor_ctx_t ctx = {A, NULL, terms};
+  parallel_for(A->rows, cofactor_work(A->rows), cofactor_rows, &ctx);
+}
+
+static void complement_rows(void *arg, int begin, int end) {
+  cofactor_ctx_t *ctx = (cofactor_ctx_t *)arg;
+  matrix_t *A = ctx->A;
+  for (int i = begin; i < end; i++) {
+    for (int j = 0; j < A->rows; j++) {
+      double determinant = 0.0;
+      matrix_t minor;
+      s21_create_matrix(A->rows - 1, A->rows - 1, &minor);
+      get_minor(A, &minor, i, j);
+      s21_determinant(&minor, &determinant);
+      ctx->result->matrix[i][j] = pow(-1, i + j) * determinant;
+      s21_remove_matrix(&minor);
+    }
+  }
+}
+
+/**
+ * @brief Алгебраические дополнения A в уже выделенную матрицу result.
+ * Строки result считаются параллельно на планировщике.
+ *
+ */
+static void complements_into(matrix_t *A, matrix_t *result) {
+  cofactor_ctx_t ctx = {A, result, NULL};
+  parallel_for(A->rows, A->rows * cofactor_work(A->rows), complement_rows,
+               &ctx);
+}
+
+/**
+ * @brief Умножение A * B в уже выделенную матрицу result. Порядок циклов
+ * i-k-j: внутренний цикл идет по строкам B и result подряд, а порядок
+ * суммирования по k для каждого элемента тот же, что в схеме i-j-k.
+ *
+ */
+static void mult_into(matrix_t *A, matrix_t *B, matrix_t *result) {
+  mult_ctx_t ctx = {A, B, result};
+  parallel_for(A->rows, (long)A->rows * A->columns * B->columns, mult_rows,
+               &ctx);
+}
+
+/**
+ * @brief Возведение квадратной матрицы A в степень power быстрым
+ * возведением в квадрат. Используются три буфера (результат, степень A и
+ * временный), которые меняются местами без выделения памяти на каждом шаге.
+ * Отрицательная степень считается через обратную матрицу, найденную
+ * LU-разложением, нулевая дает единичную.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_pow_matrix(matrix_t *A, int power, matrix_t *result) {
+  int res = OK;
+  if (!check_matrix(A)) {
+    if (A->rows == A->columns) {
+      int n = A->rows;
+      unsigned int exponent = power < 0 ? 0u - (unsigned int)power
+                                          : (unsigned int)power;
+      matrix_t acc = {0}, base = {0}, tmp = {0};
+      res = power < 0 ? lu_inverse(A, &base) : copy_matrix(A, &base);
+      if (!res) res = s21_create_matrix(n, n, &acc);
+      if (!res) res = s21_create_matrix(n, n, &tmp);
+      int identity = 1;
+      for (int i = 0; !res && i < n; i++) acc.matrix[i][i] = 1.0;
+      while (!res && exponent) {
+        if (exponent & 1u) {
+          if (identity) {
+            for (int i = 0; i < n; i++) {
+              memcpy(acc.matrix[i], base.matrix[i], n * sizeof(double));
+            }
+            identity = 0;
+          } else {
+            mult_into(&acc, &base, &tmp);
+            matrix_t swap = acc;
+            acc = tmp;
+            tmp = swap;
+          }
+        }
+        exponent >>= 1;
+        if (exponent) {
+          mult_into(&base, &base, &tmp);
+          matrix_t swap = base;
+          base = tmp;
+          tmp = swap;
+        }
+      }
+      if (!res) {
+        *result = acc;
+      } else {
+        s21_remove_matrix(&acc);
+      }
+      s21_remove_matrix(&base);
+      s21_remove_matrix(&tmp);
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+static int check_packed(packed_matrix_t *A) {
+  int err = INCORRECT_MATRIX;
+  if ((A != NULL) && (A->data != NULL) && (A->size > 0) &&
+      (A->structure >= UPPER_TRIANGULAR) && (A->structure <= BANDED)) {
+    err = OK;
+  }
+  return err;
+}
+
+/**
+ * @brief Смещение начала хранимой части строки i в A->data.
+ *
+ */
+static long packed_offset(packed_matrix_t *A, int i) {
+  long offset = i;
+  if (A->structure == UPPER_TRIANGULAR) {
+    offset = (long)i * A->size - (long)i * (i - 1) / 2;
+  } else if (A->structure == LOWER_TRIANGULAR ||
+             A->structure == SYMMETRIC) {
+    offset = (long)i * (i + 1) / 2;
+  } else if (A->structure == BANDED) {
+    offset = (long)i * (A->lower + A->upper + 1);
+  }
+  return offset;
+}
+
+/**
+ * @brief Столбец, которому соответствует первый хранимый элемент строки i
+ * (для ленточной матрицы может быть отрицательным).
+ *
+ */
+static int packed_start(packed_matrix_t *A, int i) {
+  int start = i;
+  if (A->structure == LOWER_TRIANGULAR || A->structure == SYMMETRIC) {
+    start = 0;
+  } else if (A->structure == BANDED) {
+    start = i - A->lower;
+  }
+  return start;
+}
+
+/**
+ * @brief Диапазон [*first, *last] ненулевых столбцов строки i, хранимых
+ * подряд. Для симметричной матрицы это нижний треугольник.
+ *
+ */
+static void packed_range(packed_matrix_t *A, int i, int *first, int *last) {
+  *first = packed_start(A, i);
+  *last = i;
+  if (A->structure == UPPER_TRIANGULAR) {
+    *last = A->size - 1;
+  } else if (A->structure == BANDED) {
+    *last = i + A->upper;
+  }
+  if (*first < 0) *first = 0;
+  if (*last > A->size - 1) *last = A->size - 1;
+}
+
+static double *packed_row(packed_matrix_t *A, int i, int first) {
+  return A->data + packed_offset(A, i) + (first - packed_start(A, i));
+}
+
+/**
+ * @brief Создает нулевую упакованную матрицу size * size со структурой
+ * structure. Хранится только ненулевая часть: треугольная и симметричная -
+ * size * (size + 1) / 2 элементов, диагональная - size, ленточная с lower
+ * поддиагоналями и upper наддиагоналями - size * (lower + upper + 1).
+ * Параметры lower и upper учитываются только для BANDED.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_create_packed(int size, int structure, int lower, int upper,
+                      packed_matrix_t *result) {
+  int res = INCORRECT_MATRIX;
+  if (size > 0 && structure >= UPPER_TRIANGULAR && structure <= BANDED &&
+      (structure != BANDED || (lower >= 0 && upper >= 0))) {
+    result->size = size;
+    result->structure = structure;
+    result->lower = structure == BANDED ? lower : 0;
+    result->upper = structure == BANDED ? upper : 0;
+    if (structure == UPPER_TRIANGULAR) result->upper = size - 1;
+    if (structure == LOWER_TRIANGULAR || structure == SYMMETRIC) {
+      result->lower = size - 1;
+    }
+    long length = packed_offset(result, size - 1);
+    length += structure == BANDED ? lower + upper + 1
+              : structure == LOWER_TRIANGULAR || structure == SYMMETRIC
+                  ? size
+                  : 1;
+    result->data = (double *)calloc(length, sizeof(double));
+    if (result->data) res = OK;
+  }
+  return res;
+}
+
+/**
+ * @brief Очищает упакованную матрицу A
+ *
+ */
+void s21_remove_packed(packed_matrix_t *A) {
+  if (A->data) free(A->data);
+  A->data = NULL;
+  A->size = 0;
+  A->lower = 0;
+  A->upper = 0;
+}
+
+/**
+ * @brief Указатель на хранимый элемент (i, j) упакованной матрицы A. Для
+ * симметричной матрицы (i, j) и (j, i) - один элемент.
+ *
+ * @return double* элемент или NULL, если он структурно нулевой
+ */
+double *s21_packed_at(packed_matrix_t *A, int i, int j) {
+  double *res = NULL;
+  if (!check_packed(A) && i >= 0 && j >= 0 && i < A->size && j < A->size) {
+    if (A->structure == SYMMETRIC && j > i) {
+      int tmp = i;
+      i = j;
+      j = tmp;
+    }
+    int first, last;
+    packed_range(A, i, &first, &last);
+    if (j >= first && j <= last) res = packed_row(A, i, first) + (j - first);
+  }
+  return res;
+}
+
+/**
+ * @brief Упаковывает квадратную матрицу A в структуру structure. Элементы
+ * вне хранимой части не проверяются; для SYMMETRIC берется нижний
+ * треугольник.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_pack_matrix(matrix_t *A, int structure, int lower, int upper,
+                    packed_matrix_t *result) {
+  int res = OK;
+  if (!check_matrix(A)) {
+    if (A->rows == A->columns) {
+      res = s21_create_packed(A->rows, structure, lower, upper, result);
+      for (int i = 0; !res && i < A->rows; i++) {
+        int first, last;
+        packed_range(result, i, &first, &last);
+        memcpy(packed_row(result, i, first), A->matrix[i] + first,
+               (last - first + 1) * sizeof(double));
+      }
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Распаковывает A в обычную плотную матрицу.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_unpack_matrix(packed_matrix_t *A, matrix_t *result) {
+  int res = OK;
+  if (!check_packed(A)) {
+    res = s21_create_matrix(A->size, A->size, result);
+    for (int i = 0; !res && i < A->size; i++) {
+      int first, last;
+      packed_range(A, i, &first, &last);
+      double *row = packed_row(A, i, first);
+      memcpy(result->matrix[i] + first, row,
+             (last - first + 1) * sizeof(double));
+      if (A->structure == SYMMETRIC) {
+        for (int j = first; j < i; j++) result->matrix[j][i] = row[j - first];
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Определитель упакованной матрицы A. Для треугольной и
+ * диагональной - произведение диагонали за O(n), для остальных -
+ * произведение ведущих элементов LU-разложения распакованной матрицы.
+ * Ноль возвращается только при точно нулевом ведущем элементе.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_packed_determinant(packed_matrix_t *A, double *result) {
+  int res = OK;
+  if (!check_packed(A)) {
+    if (A->structure == UPPER_TRIANGULAR ||
+        A->structure == LOWER_TRIANGULAR || A->structure == DIAGONAL) {
+      *result = 1.0;
+      for (int i = 0; i < A->size; i++) *result *= *s21_packed_at(A, i, i);
+    } else {
+      matrix_t LU = {0};
+      int *perm = (int *)calloc(A->size, sizeof(int));
+      int sign = 1;
+      res = perm ? s21_unpack_matrix(A, &LU) : INCORRECT_MATRIX;
+      if (!res) {
+        *result = 0.0;
+        if (!lu_decompose(&LU, perm, &sign, 0.0)) {
+          *result = sign;
+          for (int i = 0; i < A->size; i++) *result *= LU.matrix[i][i];
+        }
+      }
+      s21_remove_matrix(&LU);
+      free(perm);
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Решение системы A * X = B. Для треугольной матрицы - прямая или
+ * обратная подстановка за O(n^2 * m), для диагональной - деление строк
+ * (вырожденной считается только матрица с нулем на диагонали),
+ * для симметричной и ленточной - LU-разложение распакованной матрицы в
+ * double.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_packed_solve(packed_matrix_t *A, matrix_t *B, matrix_t *result) {
+  int res = OK;
+  if (!check_packed(A) && !check_matrix(B)) {
+    int n = A->size, m = B->columns;
+    if (B->rows != n) {
+      res = CALCULATION_ERROR;
+    } else if (A->structure == SYMMETRIC || A->structure == BANDED) {
+      matrix_t dense = {0};
+      res = s21_unpack_matrix(A, &dense);
+      if (!res) res = lu_solve_matrix(&dense, B, result);
+      s21_remove_matrix(&dense);
+    } else {
+      for (int i = 0; i < n && !res; i++) {
+        if (*s21_packed_at(A, i, i) == 0.0) res = CALCULATION_ERROR;
+      }
+      if (!res) res = copy_matrix(B, result);
+      int upper = A->structure == UPPER_TRIANGULAR;
+      for (int step = 0; !res && step < n; step++) {
+        int i = upper ? n - 1 - step : step;
+        int first, last;
+        packed_range(A, i, &first, &last);
+        double *row = packed_row(A, i, first);
+        for (int k = first; k <= last; k++) {
+          if (k != i) {
+            axpy_kernel(-row[k - first], result->matrix[k], result->matrix[i],
+                        0, m);
+          }
+        }
+        double inv = 1.0 / row[i - first];
+        for (int j = 0; j < m; j++) result->matrix[i][j] *= inv;
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Обратная упакованная матрица с той же структурой. Треугольная
+ * обращается построчно в упакованном виде за n^3 / 3 операций, диагональная
+ * за O(n), симметричная - LU-разложением распакованной матрицы в double.
+ * Для треугольной и диагональной вырожденной считается только матрица с
+ * нулем на диагонали. Обратная к ленточной матрице в общем случае плотная,
+ * для нее используйте s21_packed_solve.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_packed_inverse(packed_matrix_t *A, packed_matrix_t *result) {
+  int res = OK;
+  if (!check_packed(A)) {
+    int n = A->size;
+    if (A->structure == BANDED) {
+      res = CALCULATION_ERROR;
+    } else if (A->structure == SYMMETRIC) {
+      matrix_t dense = {0}, inverse = {0};
+      res = s21_unpack_matrix(A, &dense);
+      if (!res) res = lu_inverse(&dense, &inverse);
+      if (!res) res = s21_pack_matrix(&inverse, SYMMETRIC, 0, 0, result);
+      s21_remove_matrix(&dense);
+      s21_remove_matrix(&inverse);
+    } else {
+      for (int i = 0; i < n && !res; i++) {
+        if (*s21_packed_at(A, i, i) == 0.0) res = CALCULATION_ERROR;
+      }
+      if (!res) res = s21_create_packed(n, A->structure, 0, 0, result);
+      int upper = A->structure == UPPER_TRIANGULAR;
+      for (int step = 0; !res && step < n; step++) {
+        int i = upper ? n - 1 - step : step;
+        int first, last;
+        packed_range(A, i, &first, &last);
+        double *row = packed_row(A, i, first);
+        double *x = packed_row(result, i, first);
+        x[i - first] = 1.0;
+        for (int k = first; k <= last; k++) {
+          if (k != i) {
+            int k_first, k_last;
+            packed_range(result, k, &k_first, &k_last);
+            axpy_kernel(-row[k - first], packed_row(result, k, k_first),
+                        x + (k_first - first), 0, k_last - k_first + 1);
+          }
+        }
+        double inv = 1.0 / row[i - first];
+        for (int j = 0; j <= last - first; j++) x[j] *= inv;
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+typedef struct packed_mult_ctx {
+  packed_matrix_t *A;
+  matrix_t *B;
+  matrix_t *result;
+} packed_mult_ctx_t;
+
+static void packed_mult_rows(void *arg, int begin, int end) {
+  packed_mult_ctx_t *ctx = (packed_mult_ctx_t *)arg;
+  for (int i = begin; i < end; i++) {
+    int first, last;
+    packed_range(ctx->A, i, &first, &last);
+    double *row = packed_row(ctx->A, i, first);
+    for (int k = first; k <= last; k++) {
+      axpy_kernel(row[k - first], ctx->B->matrix[k], ctx->result->matrix[i], 0,
+                  ctx->B->columns);
+    }
+  }
+}
+
+/**
+ * @brief Умножение упакованной матрицы A на плотную B. Обходятся только
+ * хранимые элементы A; для симметричной матрицы каждый внедиагональный
+ * элемент читается один раз и дает вклад в две строки результата.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_packed_mult_matrix(packed_matrix_t *A, matrix_t *B,
+                           matrix_t *result) {
+  int res = OK;
+  if (!check_packed(A) && !check_matrix(B)) {
+    if (A->size == B->rows) {
+      res = s21_create_matrix(A->size, B->columns, result);
+      if (!res && A->structure == SYMMETRIC) {
+        for (int i = 0; i < A->size; i++) {
+          double *row = packed_row(A, i, 0);
+          for (int k = 0; k < i; k++) {
+            axpy_kernel(row[k], B->matrix[k], result->matrix[i], 0,
+                        B->columns);
+            axpy_kernel(row[k], B->matrix[i], result->matrix[k], 0,
+                        B->columns);
+          }
+          axpy_kernel(row[i], B->matrix[i], result->matrix[i], 0, B->columns);
+        }
+      } else if (!res) {
+        packed_mult_ctx_t ctx = {A, B, result};
+        long work = (long)(A->lower + A->upper + 1) * A->size * B->columns;
+        parallel_for(A->size, work, packed_mult_rows, &ctx);
+      }
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+enum async_operations {
+  ASYNC_MULT,
+  ASYNC_INVERSE,
+  ASYNC_DETERMINANT,
+  ASYNC_TRANSPOSE
+};
+
+struct s21_future {
+  task_t task;
+  int operation;
+  matrix_t *A;
+  matrix_t *B;
+  matrix_t *result;
+  double *determinant;
+  int status;
+  int done;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+};
+
+static void run_future(void *arg) {
+  s21_future_t *future = (s21_future_t *)arg;
+  int status = INCORRECT_MATRIX;
+  if (future->operation == ASYNC_MULT) {
+    status = s21_mult_matrix(future->A, future->B, future->result);
+  } else if (future->operation == ASYNC_INVERSE) {
+    status = s21_inverse_matrix(future->A, future->result);
+  } else if (future->operation == ASYNC_DETERMINANT) {
+    status = s21_determinant(future->A, future->determinant);
+  } else if (future->operation == ASYNC_TRANSPOSE) {
+    status = s21_transpose(future->A, future->result);
+  }
+  pthread_mutex_lock(&future->lock);
+  future->status = status;
+  future->done = 1;
+  pthread_cond_broadcast(&future->cond);
+  pthread_mutex_unlock(&future->lock);
+}
+
+static int submit_future(int operation, matrix_t *A, matrix_t *B,
+                         matrix_t *result, double *determinant,
+                         s21_future_t **future) {
+  int res = INCORRECT_MATRIX;
+  s21_future_t *created =
+      future ? (s21_future_t *)calloc(1, sizeof(s21_future_t)) : NULL;
+  if (created) {
+    created->task = (task_t){run_future, created, NULL};
+    created->operation = operation;
+    created->A = A;
+    created->B = B;
+    created->result = result;
+    created->determinant = determinant;
+    pthread_mutex_init(&created->lock, NULL);
+    pthread_cond_init(&created->cond, NULL);
+    *future = created;
+    submit_task(&created->task);
+    res = OK;
+  }
+  return res;
+}
+
+/**
+ * @brief Асинхронное умножение матриц A и B (см. s21_mult_matrix). Матрицы
+ * должны оставаться валидными до s21_future_wait.
+ *
+ * @return int OK/INCORRECT_MATRIX (не удалось создать future)
+ */
+int s21_mult_matrix_async(matrix_t *A, matrix_t *B, matrix_t *result,
+                          s21_future_t **future) {
+  return submit_future(ASYNC_MULT, A, B, result, NULL, future);
+}
+
+/**
+ * @brief Асинхронная обратная матрица A (см. s21_inverse_matrix).
+ *
+ * @return int OK/INCORRECT_MATRIX (не удалось создать future)
+ */
+int s21_inverse_matrix_async(matrix_t *A, matrix_t *result,
+                             s21_future_t **future) {
+  return submit_future(ASYNC_INVERSE, A, NULL, result, NULL, future);
+}
+
+/**
+ * @brief Асинхронный определитель матрицы A (см. s21_determinant).
+ *
+ * @return int OK/INCORRECT_MATRIX (не удалось создать future)
+ */
+int s21_determinant_async(matrix_t *A, double *result, s21_future_t **future) {
+  return submit_future(ASYNC_DETERMINANT, A, NULL, NULL, result, future);
+}
+
+/**
+ * @brief Асинхронное транспонирование матрицы A (см. s21_transpose).
+ *
+ * @return int OK/INCORRECT_MATRIX (не удалось создать future)
+ */
+int s21_transpose_async(matrix_t *A, matrix_t *result, s21_future_t **future) {
+  return submit_future(ASYNC_TRANSPOSE, A, NULL, result, NULL, future);
+}
+
+/**
+ * @brief Проверяет без блокировки, завершена ли асинхронная операция.
+ *
+ * @return int SUCCESS/FAILURE
+ */
+int s21_future_ready(s21_future_t *future) {
+  int res = FAILURE;
+  if (future) {
+    pthread_mutex_lock(&future->lock);
+    if (future->done) res = SUCCESS;
+    pthread_mutex_unlock(&future->lock);
+  }
+  return res;
+}
+
+/**
+ * @brief Ждет завершения асинхронной операции и освобождает future.
+ * Внутри рабочего потока планировщика во время ожидания выполняются
+ * другие задачи.
+ *
+ * @return int код возврата операции OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_future_wait(s21_future_t *future) {
+  int res = INCORRECT_MATRIX;
+  if (future) {
+    if (worker_id >= 0) {
+      while (s21_future_ready(future) == FAILURE) {
+        task_t *task = take_task();
+        if (task) {
+          run_task(task);
+        } else {
+          sched_yield();
+        }
+      }
+    }
+    pthread_mutex_lock(&future->lock);
+    while (!future->done) pthread_cond_wait(&future->cond, &future->lock);
+    res = future->status;
+    pthread_mutex_unlock(&future->lock);
+    pthread_mutex_destroy(&future->lock);
+    pthread_cond_destroy(&future->cond);
+    free(future);
+  }
+  return res;
+}
+
+typedef struct reader {
+  FILE *file;
+  char *buffer;
+  size_t capacity;
+  size_t size;
+  size_t pos;
+  int eof;
+} reader_t;
+
+/**
+ * @brief Дочитывает файл в буфер: непрочитанный хвост переносится в
+ * начало, при заполненном буфере его емкость удваивается. Буфер всегда
+ * завершается нулем.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int reader_fill(reader_t *reader) {
+  int res = OK;
+  if (reader->pos > 0) {
+    memmove(reader->buffer, reader->buffer + reader->pos,
+            reader->size - reader->pos);
+    reader->size -= reader->pos;
+    reader->pos = 0;
+  }
+  if (reader->size == reader->capacity) {
+    size_t capacity = reader->capacity * 2;
+    char *buffer = (char *)realloc(reader->buffer, capacity + 1);
+    if (buffer) {
+      reader->buffer = buffer;
+      reader->capacity = capacity;
+    } else {
+      res = INCORRECT_MATRIX;
+    }
+  }
+  if (!res) {
+    size_t got = fread(reader->buffer + reader->size, 1,
+                       reader->capacity - reader->size, reader->file);
+    reader->size += got;
+    if (!got) reader->eof = 1;
+  }
+  reader->buffer[reader->size] = '\0';
+  return res;
+}
+
+/**
+ * @brief Следующая строка файла [*begin, *end) без символа перевода строки.
+ *
+ * @return int 1 - строка прочитана, 0 - конец файла или ошибка
+ */
+static int reader_line(reader_t *reader, char **begin, char **end) {
+  int found = 0, res = OK;
+  while (!found && !res && (!reader->eof || reader->pos < reader->size)) {
+    char *start = reader->buffer + reader->pos;
+    char *newline = (char *)memchr(start, '\n', reader->size - reader->pos);
+    if (newline || reader->eof) {
+      *begin = start;
+      *end = newline ? newline : reader->buffer + reader->size;
+      reader->pos = *end - reader->buffer + (newline ? 1 : 0);
+      found = 1;
+    } else {
+      res = reader_fill(reader);
+    }
+  }
+  return found;
+}
+
+/**
+ * @brief Разбор числа с плавающей точкой из [p, end). Если мантисса
+ * помещается в 53 бита, а десятичный порядок не больше 22, результат
+ * считается одним точным умножением или делением (быстрый путь Клингера),
+ * иначе разбор передается strtod.
+ *
+ * @return const char* позиция после числа или NULL, если числа нет
+ */
+static const char *parse_double(const char *p, const char *end,
+                                double *value) {
+  static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *start = p;
+  int negative = 0, digits = 0, exponent = 0, any = 0, exact = 1;
+  uint64_t mantissa = 0;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  for (int fraction = 0; fraction < 2; fraction++) {
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any = 1) {
+      if (mantissa || *p != '0') {
+        if (digits < 19) {
+          mantissa = mantissa * 10 + (*p - '0');
+          digits++;
+          exponent -= fraction;
+        } else {
+          exact = 0;
+        }
+      } else {
+        exponent -= fraction;
+      }
+    }
+    if (!fraction && p < end && *p == '.') {
+      p++;
+    } else {
+      fraction = 2;
+    }
+  }
+  if (any && p < end && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    int exp_negative = 0, exp_value = 0, exp_any = 0;
+    if (q < end && (*q == '-' || *q == '+')) exp_negative = *q++ == '-';
+    for (; q < end && *q >= '0' && *q <= '9'; q++, exp_any = 1) {
+      if (exp_value < 100000) exp_value = exp_value * 10 + (*q - '0');
+    }
+    if (exp_any) {
+      exponent += exp_negative ? -exp_value : exp_value;
+      p = q;
+    }
+  }
+  if (any && exact && mantissa <= (1ull << 53) && exponent >= -22 &&
+      exponent <= 22) {
+    *value = exponent < 0 ? (double)mantissa / powers[-exponent]
+                          : (double)mantissa * powers[exponent];
+    if (negative) *value = -*value;
+  } else {
+    char *stop = NULL;
+    *value = strtod(start, &stop);
+    p = stop > start && stop <= end ? stop : NULL;
+  }
+  return p;
+}
+
+static int is_separator(char c) {
+  return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+/**
+ * @brief Разбирает строку с числами, разделенными пробелами, запятыми или
+ * точками с запятой. Если row не NULL, записывает не больше capacity
+ * значений; в *count возвращает количество чисел в строке.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int parse_row(const char *p, const char *end, double *row,
+                     int capacity, int *count) {
+  int res = OK;
+  *count = 0;
+  while (!res) {
+    while (p < end && is_separator(*p)) p++;
+    if (p == end) break;
+    double value = 0.0;
+    p = parse_double(p, end, &value);
+    if (!p || (p < end && !is_separator(*p))) {
+      res = INCORRECT_MATRIX;
+    } else {
+      if (row && *count < capacity) row[*count] = value;
+      (*count)++;
+    }
+  }
+  return res;
+}
+
+static int is_blank(const char *p, const char *end) {
+  while (p < end && is_separator(*p)) p++;
+  return p == end || *p == '#';
+}
+
+/**
+ * @brief Потоковая загрузка текстовой матрицы: каждая строка разбирается
+ * сразу в выделенную для нее строку матрицы.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int load_delimited(reader_t *reader, matrix_t *result) {
+  int res = OK, capacity = 0, count = 0;
+  char *begin, *end;
+  *result = (matrix_t){0};
+  while (!res && reader_line(reader, &begin, &end)) {
+    if (is_blank(begin, end)) continue;
+    if (!result->columns) {
+      res = parse_row(begin, end, NULL, 0, &result->columns);
+      if (!result->columns) res = INCORRECT_MATRIX;
+    }
+    if (!res && result->rows == capacity) {
+      capacity = capacity ? capacity * 2 : 64;
+      double **rows =
+          (double **)realloc(result->matrix, capacity * sizeof(double *));
+      if (rows) {
+        result->matrix = rows;
+      } else {
+        res = INCORRECT_MATRIX;
+      }
+    }
+    if (!res) {
+      double *row = (double *)calloc(result->columns, sizeof(double));
+      if (row) {
+        result->matrix[result->rows++] = row;
+        res = parse_row(begin, end, row, result->columns, &count);
+        if (count != result->columns) res = INCORRECT_MATRIX;
+      } else {
+        res = INCORRECT_MATRIX;
+      }
+    }
+  }
+  if (!result->rows) res = INCORRECT_MATRIX;
+  return res;
+}
+
+typedef struct load_ctx {
+  char **lines;
+  matrix_t *result;
+  atomic_int error;
+} load_ctx_t;
+
+static void load_rows(void *arg, int begin, int end) {
+  load_ctx_t *ctx = (load_ctx_t *)arg;
+  for (int i = begin; i < end && !atomic_load(&ctx->error); i++) {
+    int count = 0;
+    char *line_end = (char *)memchr(ctx->lines[i], '\n',
+                                    ctx->lines[i + 1] - ctx->lines[i]);
+    if (!line_end) line_end = ctx->lines[i + 1];
+    if (parse_row(ctx->lines[i], line_end, ctx->result->matrix[i],
+                  ctx->result->columns, &count) ||
+        count != ctx->result->columns) {
+      atomic_store(&ctx->error, 1);
+    }
+  }
+}
+
+/**
+ * @brief Загрузка текстовой матрицы, целиком прочитанной в буфер: строки
+ * индексируются одним проходом, затем разбираются параллельно.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int load_delimited_parallel(reader_t *reader, matrix_t *result) {
+  int res = OK, rows = 0, capacity = 1024, columns = 0;
+  char **lines = (char **)malloc((capacity + 1) * sizeof(char *));
+  char *begin, *end;
+  while (lines && reader_line(reader, &begin, &end)) {
+    if (is_blank(begin, end)) continue;
+    if (rows == capacity) {
+      capacity *= 2;
+      char **grown = (char **)realloc(lines, (capacity + 1) * sizeof(char *));
+      if (!grown) free(lines);
+      lines = grown;
+    }
+    if (lines) lines[rows++] = begin;
+    if (rows == 1) res = parse_row(begin, end, NULL, 0, &columns);
+  }
+  if (lines && rows && !res) {
+    lines[rows] = reader->buffer + reader->size;
+    res = s21_create_matrix(rows, columns, result);
+    if (!res) {
+      load_ctx_t ctx = {lines, result, 0};
+      parallel_for(rows, (long)reader->size, load_rows, &ctx);
+      if (atomic_load(&ctx.error)) res = INCORRECT_MATRIX;
+    }
+    if (res) s21_remove_matrix(result);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  free(lines);
+  return res;
+}
+
+static int parse_index(const char **p, const char *end, int limit,
+                       int *index) {
+  int res = INCORRECT_MATRIX;
+  double value = 0.0;
+  while (*p && *p < end && is_separator(**p)) (*p)++;
+  *p = *p ? parse_double(*p, end, &value) : NULL;
+  if (*p && value >= 1.0 && value <= limit && value == floor(value)) {
+    *index = (int)value - 1;
+    res = OK;
+  }
+  return res;
+}
+
+/**
+ * @brief Загрузка матрицы в формате Matrix Market (array и coordinate,
+ * real/integer/double, general/symmetric).
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int load_market(reader_t *reader, matrix_t *result) {
+  int res = INCORRECT_MATRIX;
+  char *begin, *end;
+  char header[5][32] = {{0}};
+  *result = (matrix_t){0};
+  if (reader_line(reader, &begin, &end) && end - begin < 160) {
+    char line[160] = {0};
+    memcpy(line, begin, end - begin);
+    if (sscanf(line, "%31s %31s %31s %31s %31s", header[0], header[1],
+               header[2], header[3], header[4]) == 5 &&
+        !strcasecmp(header[1], "matrix") &&
+        (!strcasecmp(header[3], "real") || !strcasecmp(header[3], "integer") ||
+         !strcasecmp(header[3], "double")) &&
+        (!strcasecmp(header[4], "general") ||
+         !strcasecmp(header[4], "symmetric"))) {
+      res = OK;
+    }
+  }
+  int coordinate = !strcasecmp(header[2], "coordinate");
+  int symmetric = !strcasecmp(header[4], "symmetric");
+  if (!res && !coordinate && strcasecmp(header[2], "array")) {
+    res = INCORRECT_MATRIX;
+  }
+  int found = 0;
+  while (!res && (found = reader_line(reader, &begin, &end)) &&
+         (*begin == '%' || is_blank(begin, end))) {
+  }
+  double size[3] = {0};
+  int count = 0;
+  if (!res && found) {
+    res = parse_row(begin, end, size, 3, &count);
+    if (count != 2 + coordinate || size[0] < 1 || size[1] < 1 ||
+        size[0] > INT32_MAX || size[1] > INT32_MAX ||
+        (symmetric && size[0] != size[1])) {
+      res = INCORRECT_MATRIX;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  if (!res) res = s21_create_matrix((int)size[0], (int)size[1], result);
+  long total = coordinate ? (long)size[2]
+               : symmetric ? (long)size[0] * ((long)size[0] + 1) / 2
+                           : (long)size[0] * (long)size[1];
+  int i = 0, j = 0;
+  for (long k = 0; !res && k < total; k++) {
+    while ((found = reader_line(reader, &begin, &end)) &&
+           (*begin == '%' || is_blank(begin, end))) {
+    }
+    const char *p = found ? begin : NULL;
+    if (coordinate) {
+      res = parse_index(&p, end, result->rows, &i);
+      if (!res) res = parse_index(&p, end, result->columns, &j);
+    }
+    double value = 0.0;
+    if (!res && p) {
+      while (p < end && is_separator(*p)) p++;
+      p = parse_double(p, end, &value);
+    }
+    if (res || !p || !is_blank(p, end)) {
+      res = INCORRECT_MATRIX;
+    } else {
+      result->matrix[i][j] = value;
+      if (symmetric) result->matrix[j][i] = value;
+      if (!coordinate && ++i == result->rows) {
+        j++;
+        i = symmetric ? j : 0;
+      }
+    }
+  }
+  if (res && result->matrix) s21_remove_matrix(result);
+  return res;
+}
+
+/**
+ * @brief Загрузка матрицы из текстового файла path. Файл, начинающийся с
+ * "%%MatrixMarket", читается как Matrix Market, иначе как CSV: числа
+ * разделены пробелами, табуляцией, запятыми или точками с запятой, пустые
+ * строки и строки с '#' пропускаются. Файл читается блоками по S21_IO_CHUNK
+ * байт; CSV размером от S21_IO_PARALLEL байт читается целиком и разбирается
+ * параллельно.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_load_matrix(const char *path, matrix_t *result) {
+  int res = INCORRECT_MATRIX;
+  FILE *file = path && result ? fopen(path, "rb") : NULL;
+  if (file) {
+    long length = 0;
+    if (!fseek(file, 0, SEEK_END)) length = ftell(file);
+    rewind(file);
+    int whole = length >= S21_IO_PARALLEL && thread_count() > 1;
+    reader_t reader = {file, NULL, whole ? (size_t)length + 1 : S21_IO_CHUNK,
+                       0, 0, 0};
+    reader.buffer = (char *)malloc(reader.capacity + 1);
+    res = reader.buffer ? reader_fill(&reader) : INCORRECT_MATRIX;
+    while (!res && whole && !reader.eof) res = reader_fill(&reader);
+    if (!res) {
+      if (!strncmp(reader.buffer, "%%MatrixMarket", 14)) {
+        res = load_market(&reader, result);
+      } else if (whole) {
+        res = load_delimited_parallel(&reader, result);
+      } else {
+        res = load_delimited(&reader, result);
+        if (res) s21_remove_matrix(result);
+      }
+    }
+    free(reader.buffer);
+    fclose(file);
+  }
+  return res;
+}
+
+/**
+ * @brief Запись матрицы A в файл path в формате FORMAT_CSV (строки через
+ * запятую) или FORMAT_MATRIX_MARKET (array real general). Числа пишутся с
+ * 17 значащими цифрами, поэтому s21_load_matrix восстанавливает их точно.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_save_matrix(const char *path, matrix_t *A, int format) {
+  int res = OK;
+  FILE *file = NULL;
+  if (!check_matrix(A) && path &&
+      (format == FORMAT_CSV || format == FORMAT_MATRIX_MARKET) &&
+      (file = fopen(path, "wb"))) {
+    char *buffer = (char *)malloc(S21_IO_CHUNK);
+    if (buffer) setvbuf(file, buffer, _IOFBF, S21_IO_CHUNK);
+    if (format == FORMAT_CSV) {
+      for (int i = 0; i < A->rows; i++) {
+        for (int j = 0; j < A->columns; j++) {
+          fprintf(file, j ? ",%.17g" : "%.17g", A->matrix[i][j]);
+        }
+        fputc('\n', file);
+      }
+    } else {
+      fprintf(file, "%%%%MatrixMarket matrix array real general\n%d %d\n",
+              A->rows, A->columns);
+      for (int j = 0; j < A->columns; j++) {
+        for (int i = 0; i < A->rows; i++) {
+          fprintf(file, "%.17g\n", A->matrix[i][j]);
+        }
+      }
+    }
+    if (ferror(file)) res = INCORRECT_MATRIX;
+    if (fclose(file)) res = INCORRECT_MATRIX;
+    free(buffer);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+static pthread_once_t alloc_once = PTHREAD_ONCE_INIT;
+static atomic_int alloc_mode = ALLOC_DEFAULT;
+
+static void init_alloc_mode(void) {
+  char *env = getenv("S21_MATRIX_HUGEPAGES");
+  if (env && atoi(env) > 0) atomic_store(&alloc_mode, ALLOC_HUGE_PAGES);
+}
+
+/**
+ * @brief Режим выделения памяти для новых матриц. В режиме
+ * ALLOC_HUGE_PAGES матрицы от S21_HUGE_PAGE байт размещаются одним блоком
+ * на больших страницах. Начальное значение берется из переменной окружения
+ * S21_MATRIX_HUGEPAGES.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_set_alloc_mode(int mode) {
+  int res = OK;
+  pthread_once(&alloc_once, init_alloc_mode);
+  if (mode == ALLOC_DEFAULT || mode == ALLOC_HUGE_PAGES) {
+    atomic_store(&alloc_mode, mode);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+static size_t block_length(matrix_t *A) {
+  size_t bytes = (size_t)A->rows * A->columns * sizeof(double);
+  return (bytes + S21_HUGE_PAGE - 1) / S21_HUGE_PAGE * S21_HUGE_PAGE;
+}
+
+static void touch_rows(void *arg, int begin, int end) {
+  matrix_t *A = (matrix_t *)arg;
+  for (int i = begin; i < end; i++) {
+    memset(A->matrix[i], 0, A->columns * sizeof(double));
+  }
+}
+
+/**
+ * @brief Выделяет данные матрицы одним блоком на больших страницах: сначала
+ * явные (MAP_HUGETLB), при их отсутствии - прозрачные (MADV_HUGEPAGE).
+ * Страницы заполняются через parallel_for по строкам: кусок t заполняет
+ * закрепленный поток t, и тот же поток потом получает те же строки в
+ * построчных ядрах (mult_rows, gemv_rows; в reduce_blocks - с точностью до
+ * блока из S21_REDUCE_BLOCK строк), так что по политике first touch строки
+ * лежат на его узле NUMA. Ядра, делящие работу
+ * по столбцам (gemv_t_columns, column_abs_sums), читают все строки и
+ * локальности не получают. Если режим ALLOC_DEFAULT, матрица мала или mmap
+ * не удался, A->block остается NULL.
+ *
+ */
+static void alloc_block(matrix_t *A) {
+  pthread_once(&alloc_once, init_alloc_mode);
+  size_t bytes = (size_t)A->rows * A->columns * sizeof(double);
+  if (atomic_load(&alloc_mode) == ALLOC_HUGE_PAGES && bytes >= S21_HUGE_PAGE) {
+    size_t length = block_length(A);
+    void *block = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    block = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (block == MAP_FAILED) {
+      block = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+      if (block != MAP_FAILED) madvise(block, length, MADV_HUGEPAGE);
+#endif
+    }
+    if (block != MAP_FAILED) {
+      A->block = block;
+      for (int i = 0; i < A->rows; i++) {
+        A->matrix[i] = (double *)block + (size_t)i * A->columns;
+      }
+      parallel_for(A->rows, (long)A->rows * A->columns, touch_rows, A);
+    }
+  }
+}
+
+static void free_block(matrix_t *A) {
+  munmap(A->block, block_length(A));
+  for (int i = 0; i < A->rows && A->matrix; i++) A->matrix[i] = NULL;
+  A->block = NULL;
+}
+
+enum reductions {
+  REDUCE_SUM,
+  REDUCE_SQUARES,
+  REDUCE_ROW_ABS,
+  REDUCE_MIN_MAX,
+  REDUCE_MAX_ABS
+};
+
+typedef struct reduce_ctx {
+  matrix_t *A;
+  int operation;
+  double scale;
+  double *partial;
+  double *partial_max;
+} reduce_ctx_t;
+
+static double sum_kernel(const double *x, int n) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += x[i];
+    s1 += x[i + 1];
+    s2 += x[i + 2];
+    s3 += x[i + 3];
+  }
+  for (; i < n; i++) s0 += x[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+static double abs_sum_kernel(const double *x, int n) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += fabs(x[i]);
+    s1 += fabs(x[i + 1]);
+    s2 += fabs(x[i + 2]);
+    s3 += fabs(x[i + 3]);
+  }
+  for (; i < n; i++) s0 += fabs(x[i]);
+  return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * @brief Максимум и минимум, в которых NaN распространяется (fmax и fmin
+ * его отбрасывают).
+ *
+ */
+static double nan_max(double a, double b) { return a > b || isnan(a) ? a : b; }
+
+static double nan_min(double a, double b) { return a < b || isnan(a) ? a : b; }
+
+/**
+ * @brief Обновляет *min и *max по x; если в x есть NaN, оба становятся NaN.
+ * Четыре независимые дорожки в массивах позволяют векторизовать тело
+ * цикла. Дорожка z становится NaN на NaN или бесконечности, и только тогда
+ * строка проверяется на NaN скалярно.
+ *
+ */
+static void min_max_kernel(const double *x, int n, double *min, double *max) {
+  double lo[4] = {*min, *min, *min, *min}, hi[4] = {*max, *max, *max, *max};
+  double z[4] = {0.0, 0.0, 0.0, 0.0};
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (int l = 0; l < 4; l++) {
+      lo[l] = x[i + l] < lo[l] ? x[i + l] : lo[l];
+      hi[l] = x[i + l] > hi[l] ? x[i + l] : hi[l];
+      z[l] += x[i + l] * 0.0;
+    }
+  }
+  for (; i < n; i++) {
+    lo[0] = x[i] < lo[0] ? x[i] : lo[0];
+    hi[0] = x[i] > hi[0] ? x[i] : hi[0];
+    z[0] += x[i] * 0.0;
+  }
+  for (int l = 1; l < 4; l++) {
+    lo[0] = nan_min(lo[0], lo[l]);
+    hi[0] = nan_max(hi[0], hi[l]);
+  }
+  if ((z[0] + z[1]) + (z[2] + z[3]) != 0.0) {
+    for (i = 0; i < n && !isnan(lo[0]); i++) {
+      if (isnan(x[i])) lo[0] = hi[0] = x[i];
+    }
+  }
+  *min = lo[0];
+  *max = hi[0];
+}
+
+/**
+ * @brief Считает частичный результат для блоков строк [begin, end). Блок -
+ * S21_REDUCE_BLOCK строк, его результат не зависит от того, какой поток его
+ * обработал.
+ *
+ */
+static void reduce_blocks(void *arg, int begin, int end) {
+  reduce_ctx_t *ctx = (reduce_ctx_t *)arg;
+  matrix_t *A = ctx->A;
+  for (int b = begin; b < end; b++) {
+    int last = (b + 1) * S21_REDUCE_BLOCK;
+    if (last > A->rows) last = A->rows;
+    double acc = 0.0;
+    double lo = A->matrix[b * S21_REDUCE_BLOCK][0], hi = lo;
+    for (int i = b * S21_REDUCE_BLOCK; i < last; i++) {
+      if (ctx->operation == REDUCE_SUM) {
+        acc += sum_kernel(A->matrix[i], A->columns);
+      } else if (ctx->operation == REDUCE_SQUARES) {
+        acc += scaled_squares_kernel(A->matrix[i], A->columns, ctx->scale);
+      } else if (ctx->operation == REDUCE_ROW_ABS) {
+        acc = nan_max(acc, abs_sum_kernel(A->matrix[i], A->columns));
+      } else if (ctx->operation == REDUCE_MAX_ABS) {
+        acc = nan_max(acc, max_abs_kernel(A->matrix[i], A->columns));
+      } else {
+        min_max_kernel(A->matrix[i], A->columns, &lo, &hi);
+      }
+    }
+    ctx->partial[b] = ctx->operation == REDUCE_MIN_MAX ? lo : acc;
+    if (ctx->partial_max) ctx->partial_max[b] = hi;
+  }
+}
+
+/**
+ * @brief Редукция по матрице A: частичные результаты блоков строк
+ * считаются параллельно, а складываются последовательно в порядке блоков,
+ * поэтому результат не зависит от числа потоков. Для REDUCE_SQUARES
+ * элементы перед возведением в квадрат умножаются на scale.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+static int reduce(matrix_t *A, int operation, double scale, double *result,
+                  double *max) {
+  int res = OK;
+  int blocks = (A->rows + S21_REDUCE_BLOCK - 1) / S21_REDUCE_BLOCK;
+  double *partial = (double *)calloc(blocks, sizeof(double));
+  double *partial_max = max ? (double *)calloc(blocks, sizeof(double)) : NULL;
+  if (partial && (!max || partial_max)) {
+    reduce_ctx_t ctx = {A, operation, scale, partial, partial_max};
+    parallel_for(blocks, (long)A->rows * A->columns, reduce_blocks, &ctx);
+    *result = partial[0];
+    if (max) *max = partial_max[0];
+    for (int b = 1; b < blocks; b++) {
+      if (operation == REDUCE_SUM || operation == REDUCE_SQUARES) {
+        *result += partial[b];
+      } else if (operation == REDUCE_ROW_ABS || operation == REDUCE_MAX_ABS) {
+        *result = nan_max(*result, partial[b]);
+      } else {
+        *result = nan_min(*result, partial[b]);
+        *max = nan_max(*max, partial_max[b]);
+      }
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  free(partial);
+  free(partial_max);
+  return res;
+}
+
+/**
+ * @brief След квадратной матрицы A.
+ *
+ * @return int OK/INCORRECT_MATRIX/CALCULATION_ERROR
+ */
+int s21_trace(matrix_t *A, double *result) {
+  int res = OK;
+  if (!check_matrix(A) && result) {
+    if (A->rows == A->columns) {
+      *result = 0.0;
+      for (int i = 0; i < A->rows; i++) *result += A->matrix[i][i];
+    } else {
+      res = CALCULATION_ERROR;
+    }
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  return res;
+}
+
+/**
+ * @brief Сумма всех элементов матрицы A.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_sum_elements(matrix_t *A, double *result) {
+  int res = INCORRECT_MATRIX;
+  if (!check_matrix(A) && result) {
+    res = reduce(A, REDUCE_SUM, 1.0, result, NULL);
+  }
+  return res;
+}
+
+/**
+ * @brief Норма Фробениуса матрицы A. Как и в s21_norm, при переполнении
+ * или потере точности суммы квадратов она пересчитывается по элементам,
+ * отмасштабированным по максимальному модулю.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_norm_frobenius(matrix_t *A, double *result) {
+  int res = INCORRECT_MATRIX;
+  if (!check_matrix(A) && result) {
+    res = reduce(A, REDUCE_SQUARES, 1.0, result, NULL);
+    if (!res && needs_scaling(*result)) {
+      double max = 0.0;
+      res = reduce(A, REDUCE_MAX_ABS, 1.0, &max, NULL);
+      if (!res && max > 0.0 && isfinite(max)) {
+        int e = 0;
+        double scale = norm_scale(max, &e);
+        res = reduce(A, REDUCE_SQUARES, scale, result, NULL);
+        if (!res) *result = ldexp(sqrt(*result), e);
+      } else if (!res) {
+        *result = max;
+      }
+    } else if (!res) {
+      *result = sqrt(*result);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Бесконечная норма матрицы A (максимальная сумма модулей по
+ * строкам). Если в A есть NaN, результат - NaN.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_norm_inf(matrix_t *A, double *result) {
+  int res = INCORRECT_MATRIX;
+  if (!check_matrix(A) && result) {
+    res = reduce(A, REDUCE_ROW_ABS, 1.0, result, NULL);
+  }
+  return res;
+}
+
+/**
+ * @brief y[begin..end) += |x[begin..end)|. Тело развернуто на четыре
+ * элемента, как в axpy_kernel, чтобы цикл векторизовался при -O2.
+ *
+ */
+static void abs_add_kernel(const double *restrict x, double *restrict y,
+                           int begin, int end) {
+  int j = begin;
+  for (; j + 4 <= end; j += 4) {
+    y[j] += fabs(x[j]);
+    y[j + 1] += fabs(x[j + 1]);
+    y[j + 2] += fabs(x[j + 2]);
+    y[j + 3] += fabs(x[j + 3]);
+  }
+  for (; j < end; j++) y[j] += fabs(x[j]);
+}
+
+static void column_abs_sums(void *arg, int begin, int end) {
+  gemv_ctx_t *ctx = (gemv_ctx_t *)arg;
+  for (int i = 0; i < ctx->A->rows; i++) {
+    abs_add_kernel(ctx->A->matrix[i], ctx->y, begin, end);
+  }
+}
+
+/**
+ * @brief 1-норма матрицы A (максимальная сумма модулей по столбцам).
+ * Каждый поток суммирует свой диапазон столбцов по всем строкам по
+ * порядку, поэтому результат не зависит от числа потоков. Если в A есть
+ * NaN, результат - NaN.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_norm_one(matrix_t *A, double *result) {
+  int res = OK;
+  double *sums = NULL;
+  if (!check_matrix(A) && result &&
+      (sums = (double *)calloc(A->columns, sizeof(double)))) {
+    gemv_ctx_t ctx = {A, NULL, sums};
+    parallel_for(A->columns, (long)A->rows * A->columns, column_abs_sums,
+                 &ctx);
+    *result = 0.0;
+    for (int j = 0; j < A->columns; j++) *result = nan_max(*result, sums[j]);
+  } else {
+    res = INCORRECT_MATRIX;
+  }
+  free(sums);
+  return res;
+}
+
+/**
+ * @brief Минимальный и максимальный элементы матрицы A. Если в A есть
+ * NaN, оба результата - NaN.
+ *
+ * @return int OK/INCORRECT_MATRIX
+ */
+int s21_min_max(matrix_t *A, double *min, double *max) {
+  int res = INCORRECT_MATRIX;
+  if (!check_matrix(A) && min && max) {
+    res = reduce(A, REDUCE_MIN_MAX, 1.0, min, max);
+  }
+  return res;
+}
@@ -8,18 +8,62 @@
 #define SUCCESS 1
 #define FAILURE 0
 #define EPS 1e-7
+#define S21_EQ_BLOCK 64
+#define S21_REDUCE_BLOCK 64
+#define S21_REFINE_ITERS 30
+#define S21_IO_CHUNK (1 << 20)
+#define S21_IO_PARALLEL (1L << 22)
+#define S21_HUGE_PAGE (1UL << 21)
+#define S21_MAX_THREADS 64
+#define S21_PARALLEL_THRESHOLD (1L << 18)
 
 typedef struct matrix_struct {
   double **matrix;
   int rows;
   int columns;
+  void *block;
+  /* Хеш от s21_matrix_hash. После любой записи в matrix обнулите hashed
+   * (или посчитайте хеш заново), иначе s21_eq_matrix_hash сравнит по
+   * устаревшему хешу. */
+  unsigned long long hash;
+  int hashed;
 } matrix_t;
 
+typedef struct matrix_f_struct {
+  float **matrix;
+  int rows;
+  int columns;
+} matrix_f_t;
+
+typedef struct packed_matrix_struct {
+  double *data;
+  int size;
+  int structure;
+  int lower;
+  int upper;
+} packed_matrix_t;
+
+typedef struct s21_future s21_future_t;
+
 enum returns { OK, INCORRECT_MATRIX, CALCULATION_ERROR };
+enum eq_modes { EQ_ABSOLUTE, EQ_RELATIVE, EQ_ULP };
+enum formats { FORMAT_CSV, FORMAT_MATRIX_MARKET };
+enum alloc_modes { ALLOC_DEFAULT, ALLOC_HUGE_PAGES };
+enum structures {
+  UPPER_TRIANGULAR,
+  LOWER_TRIANGULAR,
+  DIAGONAL,
+  SYMMETRIC,
+  BANDED
+};
 
 int s21_create_matrix(int rows, int columns, matrix_t *result);
 void s21_remove_matrix(matrix_t *A);
+int s21_set_alloc_mode(int mode);
 int s21_eq_matrix(matrix_t *A, matrix_t *B);
+int s21_eq_matrix_tol(matrix_t *A, matrix_t *B, int mode, double tolerance);
+int s21_matrix_hash(matrix_t *A, unsigned long long *result);
+int s21_eq_matrix_hash(matrix_t *A, matrix_t *B);
 int s21_sum_matrix(matrix_t *A, matrix_t *B, matrix_t *result);
 int s21_sub_matrix(matrix_t *A, matrix_t *B, matrix_t *result);
 int s21_mult_number(matrix_t *A, double number, matrix_t *result);
@@ -29,6 +73,64 @@ int s21_calc_complements(matrix_t *A, matrix_t *result);
 int s21_determinant(matrix_t *A, double *result);
 int s21_inverse_matrix(matrix_t *A, matrix_t *result);
 
+int s21_mult_vector(matrix_t *A, double *x, double *result);
+int s21_mult_vector_transpose(matrix_t *A, double *x, double *result);
+int s21_dot(double *x, double *y, int size, double *result);
+int s21_norm(double *x, int size, double *result);
+
+int s21_create_matrix_f(int rows, int columns, matrix_f_t *result);
+void s21_remove_matrix_f(matrix_f_t *A);
+int s21_sum_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result);
+int s21_sub_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result);
+int s21_mult_number_f(matrix_f_t *A, float number, matrix_f_t *result);
+int s21_mult_matrix_f(matrix_f_t *A, matrix_f_t *B, matrix_f_t *result);
+int s21_transpose_f(matrix_f_t *A, matrix_f_t *result);
+int s21_determinant_f(matrix_f_t *A, float *result);
+int s21_inverse_matrix_f(matrix_f_t *A, matrix_f_t *result);
+int s21_convert_to_f(matrix_t *A, matrix_f_t *result);
+int s21_convert_from_f(matrix_f_t *A, matrix_t *result);
+int s21_solve_mixed(matrix_t *A, matrix_t *B, matrix_t *result);
+int s21_inverse_matrix_mixed(matrix_t *A, matrix_t *result);
+
+int s21_pow_matrix(matrix_t *A, int power, matrix_t *result);
+
+int s21_inverse_update(matrix_t *inverse, double determinant, matrix_t *U,
+                       matrix_t *V, matrix_t *result, double *result_det);
+int s21_inverse_update_rank1(matrix_t *inverse, double determinant, double *u,
+                             double *v, matrix_t *result, double *result_det);
+
+int s21_create_packed(int size, int structure, int lower, int upper,
+                      packed_matrix_t *result);
+void s21_remove_packed(packed_matrix_t *A);
+double *s21_packed_at(packed_matrix_t *A, int i, int j);
+int s21_pack_matrix(matrix_t *A, int structure, int lower, int upper,
+                    packed_matrix_t *result);
+int s21_unpack_matrix(packed_matrix_t *A, matrix_t *result);
+int s21_packed_determinant(packed_matrix_t *A, double *result);
+int s21_packed_solve(packed_matrix_t *A, matrix_t *B, matrix_t *result);
+int s21_packed_inverse(packed_matrix_t *A, packed_matrix_t *result);
+int s21_packed_mult_matrix(packed_matrix_t *A, matrix_t *B, matrix_t *result);
+
+int s21_mult_matrix_async(matrix_t *A, matrix_t *B, matrix_t *result,
+                          s21_future_t **future);
+int s21_inverse_matrix_async(matrix_t *A, matrix_t *result,
+                             s21_future_t **future);
+int s21_determinant_async(matrix_t *A, double *result, s21_future_t **future);
+int s21_transpose_async(matrix_t *A, matrix_t *result, s21_future_t **future);
+int s21_future_ready(s21_future_t *future);
+int s21_future_wait(s21_future_t *future);
+void s21_scheduler_shutdown(void);
+
+int s21_trace(matrix_t *A, double *result);
+int s21_sum_elements(matrix_t *A, double *result);
+int s21_norm_frobenius(matrix_t *A, double *result);
+int s21_norm_one(matrix_t *A, double *result);
+int s21_norm_inf(matrix_t *A, double *result);
+int s21_min_max(matrix_t *A, double *min, double *max);
+
+int s21_load_matrix(const char *path, matrix_t *result);
+int s21_save_matrix(const char *path, matrix_t *A, int format);
+
 int check_matrix(matrix_t *A);
 void get_minor(matrix_t *A, matrix_t *result, int a, int b);
 int matrix_size_eq(matrix_t *A, matrix_t *B);
@@ -0,0 +1,64 @@
+#include <time.h>
+
+#include "s21_matrix.h"
+
+double elapsed(struct timespec *start);
+void run_bench(const char *name, int mode, int size, int repeat);
+
+double elapsed(struct timespec *start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+void run_bench(const char *name, int mode, int size, int repeat) {
+  struct timespec start;
+  matrix_t A = {0}, B = {0}, C = {0};
+  double *x = calloc(size, sizeof(double));
+  double *y = calloc(size, sizeof(double));
+  s21_set_alloc_mode(mode);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  s21_create_matrix(size, size, &A);
+  s21_create_matrix(size / 2, size / 2, &B);
+  double create = elapsed(&start);
+  for (int i = 0; i < size; i++) {
+    x[i] = 1.0 / (i + 1);
+    for (int j = 0; j < size; j++) A.matrix[i][j] = (i ^ j) % 17 - 8.0;
+  }
+  for (int i = 0; i < size / 2; i++) {
+    for (int j = 0; j < size / 2; j++) B.matrix[i][j] = A.matrix[i][j];
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int r = 0; r < repeat; r++) s21_mult_vector(&A, x, y);
+  double gemv = elapsed(&start) / repeat;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int r = 0; r < repeat; r++) s21_mult_vector_transpose(&A, x, y);
+  double gemv_t = elapsed(&start) / repeat;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  s21_mult_matrix(&B, &B, &C);
+  double mult = elapsed(&start);
+
+  double bytes = (double)size * size * sizeof(double);
+  printf("%-8s create %8.3f ms  gemv %8.3f ms (%6.2f GB/s)  "
+         "gemv_t %8.3f ms (%6.2f GB/s)  mult %8.3f ms  block %s\n",
+         name, create * 1e3, gemv * 1e3, bytes / gemv * 1e-9, gemv_t * 1e3,
+         bytes / gemv_t * 1e-9, mult * 1e3, A.block ? "yes" : "no");
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&B);
+  s21_remove_matrix(&C);
+  free(x);
+  free(y);
+}
+
+int main(int argc, char **argv) {
+  int size = argc > 1 ? atoi(argv[1]) : 2048;
+  int repeat = argc > 2 ? atoi(argv[2]) : 20;
+  if (size < 2) size = 2048;
+  if (repeat < 1) repeat = 20;
+  run_bench("default", ALLOC_DEFAULT, size, repeat);
+  run_bench("huge", ALLOC_HUGE_PAGES, size, repeat);
+  s21_scheduler_shutdown();
+  return 0;
+}
@@ -379,6 +379,41 @@ START_TEST(test_s21_determinant) {
 }
 END_TEST
 
+START_TEST(test_s21_determinant_large) {
+  int n = 9;
+  double check = 1.0;
+  matrix_t A = {0}, inverse = {0}, product = {0};
+  s21_create_matrix(n, n, &A);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < i; j++) A.matrix[i][j] = rand_float(-1, 1);
+    A.matrix[i][i] = rand_float(1, 2);
+    check *= A.matrix[i][i];
+  }
+  double res = 0.0;
+  ck_assert_int_eq(s21_determinant(&A, &res), OK);
+  ck_assert_double_eq_tol(res, check, 1e-12 * fabs(check));
+
+  s21_remove_matrix(&A);
+
+  n = 8;
+  s21_create_matrix(n, n, &A);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A.matrix[i][j] = rand_float(-1, 1);
+    A.matrix[i][i] += n;
+  }
+  ck_assert_int_eq(s21_inverse_matrix(&A, &inverse), OK);
+  ck_assert_int_eq(s21_mult_matrix(&inverse, &A, &product), OK);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      ck_assert_double_eq_tol(product.matrix[i][j], i == j, 1e-9);
+    }
+  }
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&inverse);
+  s21_remove_matrix(&product);
+}
+END_TEST
+
 START_TEST(test_s21_inverse_matrix) {
   int shape = 3;
   matrix_t A = {0};
@@ -481,6 +516,769 @@ START_TEST(test_s21_inverse_matrix) {
 }
 END_TEST
 
+START_TEST(test_s21_mult_vector) {
+  int sizes[][2] = {{rand_int(), rand_int()}, {1024, 300}};
+  for (int t = 0; t < 2; t++) {
+    int rows = sizes[t][0], cols = sizes[t][1];
+    matrix_t A = {0};
+    s21_create_matrix(rows, cols, &A);
+    double *x = calloc(cols, sizeof(double));
+    double *y = calloc(rows, sizeof(double));
+    double *xt = calloc(rows, sizeof(double));
+    double *yt = calloc(cols, sizeof(double));
+    for (int i = 0; i < rows; i++) {
+      xt[i] = rand_float(-10, 10);
+      for (int j = 0; j < cols; j++) A.matrix[i][j] = rand_float(-10, 10);
+    }
+    for (int j = 0; j < cols; j++) x[j] = rand_float(-10, 10);
+
+    ck_assert_int_eq(s21_mult_vector(&A, x, y), OK);
+    ck_assert_int_eq(s21_mult_vector_transpose(&A, xt, yt), OK);
+    for (int i = 0; i < rows; i++) {
+      double check = 0.0;
+      for (int j = 0; j < cols; j++) check += A.matrix[i][j] * x[j];
+      ck_assert_double_eq_tol(check, y[i], 1e-6);
+    }
+    for (int j = 0; j < cols; j++) {
+      double check = 0.0;
+      for (int i = 0; i < rows; i++) check += A.matrix[i][j] * xt[i];
+      ck_assert_double_eq_tol(check, yt[j], 1e-6);
+    }
+    s21_remove_matrix(&A);
+    ck_assert_int_eq(s21_mult_vector(&A, x, y), INCORRECT_MATRIX);
+    ck_assert_int_eq(s21_mult_vector_transpose(&A, xt, yt), INCORRECT_MATRIX);
+    free(x);
+    free(y);
+    free(xt);
+    free(yt);
+  }
+}
+END_TEST
+
+START_TEST(test_s21_dot) {
+  double x[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+  double y[] = {7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0};
+  double res = 0.0;
+  ck_assert_int_eq(s21_dot(x, y, 7, &res), OK);
+  ck_assert_double_eq_tol(res, 84.0, EPS);
+  ck_assert_int_eq(s21_norm(x, 2, &res), OK);
+  ck_assert_double_eq_tol(res, sqrt(5.0), EPS);
+  double big[] = {3e200, 4e200, 0.0, 0.0, 0.0};
+  double tiny[] = {3e-200, 4e-200, 0.0, 0.0, 0.0};
+  ck_assert_int_eq(s21_norm(big, 5, &res), OK);
+  ck_assert_double_eq_tol(res / 5e200, 1.0, EPS);
+  ck_assert_int_eq(s21_norm(tiny, 5, &res), OK);
+  ck_assert_double_eq_tol(res / 5e-200, 1.0, EPS);
+  ck_assert_int_eq(s21_dot(x, y, 0, &res), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_norm(NULL, 7, &res), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_matrix_f) {
+  int rows = rand_int(), cols = rand_int();
+  matrix_t A = {0}, B = {0}, check = {0};
+  s21_create_matrix(rows, cols, &A);
+  s21_create_matrix(cols, rows, &B);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      A.matrix[i][j] = rand_float(-10, 10);
+      B.matrix[j][i] = rand_float(-10, 10);
+    }
+  }
+  matrix_f_t Af = {0}, Bf = {0}, Tf = {0}, res = {0};
+  ck_assert_int_eq(s21_convert_to_f(&A, &Af), OK);
+  ck_assert_int_eq(s21_convert_to_f(&B, &Bf), OK);
+  ck_assert_int_eq(s21_transpose_f(&Bf, &Tf), OK);
+
+  ck_assert_int_eq(s21_sum_matrix_f(&Af, &Tf, &res), OK);
+  ck_assert_double_eq_tol(res.matrix[rows - 1][0],
+                          A.matrix[rows - 1][0] + B.matrix[0][rows - 1], 1e-4);
+  s21_remove_matrix_f(&res);
+  ck_assert_int_eq(s21_sub_matrix_f(&Af, &Tf, &res), OK);
+  ck_assert_double_eq_tol(res.matrix[0][cols - 1],
+                          A.matrix[0][cols - 1] - B.matrix[cols - 1][0], 1e-4);
+  s21_remove_matrix_f(&res);
+  ck_assert_int_eq(s21_mult_number_f(&Af, 2.0f, &res), OK);
+  ck_assert_double_eq_tol(res.matrix[0][0], 2.0 * A.matrix[0][0], 1e-4);
+  s21_remove_matrix_f(&res);
+
+  s21_mult_matrix(&A, &B, &check);
+  ck_assert_int_eq(s21_mult_matrix_f(&Af, &Bf, &res), OK);
+  matrix_t res_d = {0};
+  ck_assert_int_eq(s21_convert_from_f(&res, &res_d), OK);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < rows; j++) {
+      ck_assert_double_eq_tol(res_d.matrix[i][j], check.matrix[i][j], 1e-1);
+    }
+  }
+  ck_assert_int_eq(s21_sum_matrix_f(&Af, &Bf, &res), rows == cols ? OK
+                                                        : CALCULATION_ERROR);
+  ck_assert_int_eq(s21_mult_matrix_f(&Af, &Af, &res), rows == cols ? OK
+                                                         : CALCULATION_ERROR);
+  s21_remove_matrix_f(&res);
+  s21_remove_matrix(&res_d);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&B);
+  s21_remove_matrix_f(&Af);
+  s21_remove_matrix_f(&Bf);
+  s21_remove_matrix_f(&Tf);
+  ck_assert_int_eq(s21_transpose_f(&Af, &res), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_convert_to_f(&A, &Af), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_determinant_f) {
+  matrix_f_t A = {0};
+  s21_create_matrix_f(3, 3, &A);
+  float val[] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  for (int i = 0; i < 9; i++) A.matrix[i / 3][i % 3] = val[i];
+  float det = 0.0f;
+  ck_assert_int_eq(s21_determinant_f(&A, &det), OK);
+  ck_assert_float_eq_tol(det, -1.0f, 1e-5);
+
+  matrix_f_t res = {0};
+  ck_assert_int_eq(s21_inverse_matrix_f(&A, &res), OK);
+  float check[] = {1, -1, 1, -38, 41, -34, 27, -29, 24};
+  for (int i = 0; i < 9; i++) {
+    ck_assert_float_eq_tol(res.matrix[i / 3][i % 3], check[i], 1e-3);
+  }
+  s21_remove_matrix_f(&res);
+
+  for (int j = 0; j < 3; j++) A.matrix[2][j] = A.matrix[0][j];
+  ck_assert_int_eq(s21_determinant_f(&A, &det), OK);
+  ck_assert_float_eq_tol(det, 0.0f, 1e-5);
+  ck_assert_int_eq(s21_inverse_matrix_f(&A, &res), CALCULATION_ERROR);
+  s21_remove_matrix_f(&A);
+
+  s21_create_matrix_f(2, 2, &A);
+  A.matrix[0][0] = 1.0f;
+  A.matrix[1][1] = 1e-9f;
+  ck_assert_int_eq(s21_determinant_f(&A, &det), OK);
+  ck_assert_float_eq_tol(det / 1e-9f, 1.0f, 1e-6);
+  s21_remove_matrix_f(&A);
+
+  s21_create_matrix_f(2, 3, &A);
+  ck_assert_int_eq(s21_determinant_f(&A, &det), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_inverse_matrix_f(&A, &res), CALCULATION_ERROR);
+  s21_remove_matrix_f(&A);
+  ck_assert_int_eq(s21_determinant_f(&A, &det), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_solve_mixed) {
+  int n = 50;
+  matrix_t A = {0}, inverse = {0}, check = {0};
+  s21_create_matrix(n, n, &A);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A.matrix[i][j] = rand_float(-1, 1);
+    A.matrix[i][i] += n;
+  }
+  ck_assert_int_eq(s21_inverse_matrix_mixed(&A, &inverse), OK);
+  s21_mult_matrix(&A, &inverse, &check);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      ck_assert_double_eq_tol(check.matrix[i][j], i == j, 1e-14);
+    }
+  }
+  s21_remove_matrix(&inverse);
+  s21_remove_matrix(&check);
+
+  matrix_t B = {0}, X = {0};
+  s21_create_matrix(6, 1, &B);
+  matrix_t H = {0};
+  s21_create_matrix(6, 6, &H);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) H.matrix[i][j] = 1.0 / (i + j + 1);
+    for (int j = 0; j < 6; j++) B.matrix[i][0] += H.matrix[i][j];
+  }
+  ck_assert_int_eq(s21_solve_mixed(&H, &B, &X), OK);
+  for (int i = 0; i < 6; i++) ck_assert_double_eq_tol(X.matrix[i][0], 1, 1e-7);
+  s21_remove_matrix(&X);
+
+  for (int j = 0; j < 6; j++) H.matrix[5][j] = H.matrix[4][j];
+  ck_assert_int_eq(s21_solve_mixed(&H, &B, &X), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_solve_mixed(&A, &B, &X), CALCULATION_ERROR);
+  s21_remove_matrix(&H);
+  s21_remove_matrix(&B);
+  s21_remove_matrix(&A);
+  ck_assert_int_eq(s21_inverse_matrix_mixed(&A, &X), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_inverse_update) {
+  int n = 6, k = 2;
+  matrix_t A = {0}, U = {0}, V = {0}, inverse = {0};
+  s21_create_matrix(n, n, &A);
+  s21_create_matrix(n, k, &U);
+  s21_create_matrix(n, k, &V);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A.matrix[i][j] = rand_float(-1, 1);
+    for (int j = 0; j < k; j++) {
+      U.matrix[i][j] = rand_float(-1, 1);
+      V.matrix[i][j] = rand_float(-1, 1);
+    }
+    A.matrix[i][i] += n;
+  }
+  double det = 0.0;
+  s21_determinant(&A, &det);
+  s21_inverse_matrix(&A, &inverse);
+
+  matrix_t updated = {0}, check = {0}, UV = {0}, Vt = {0}, res = {0};
+  s21_transpose(&V, &Vt);
+  s21_mult_matrix(&U, &Vt, &UV);
+  s21_sum_matrix(&A, &UV, &updated);
+  double check_det = 0.0, res_det = 0.0;
+  s21_determinant(&updated, &check_det);
+  s21_inverse_matrix(&updated, &check);
+
+  ck_assert_int_eq(s21_inverse_update(&inverse, det, &U, &V, &res, &res_det),
+                   OK);
+  ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+  ck_assert_double_eq_tol(res_det, check_det, 1e-6 * fabs(check_det));
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&updated);
+  s21_remove_matrix(&UV);
+
+  double u[6] = {0}, v[6] = {0};
+  u[2] = 1.0;
+  for (int j = 0; j < n; j++) v[j] = rand_float(-1, 1);
+  s21_mult_number(&A, 1.0, &updated);
+  for (int j = 0; j < n; j++) updated.matrix[2][j] += v[j];
+  s21_determinant(&updated, &check_det);
+  s21_inverse_matrix(&updated, &check);
+  ck_assert_int_eq(
+      s21_inverse_update_rank1(&inverse, det, u, v, &res, &res_det), OK);
+  ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+  ck_assert_double_eq_tol(res_det, check_det, 1e-6 * fabs(check_det));
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&updated);
+
+  for (int j = 0; j < n; j++) v[j] = -A.matrix[2][j];
+  ck_assert_int_eq(
+      s21_inverse_update_rank1(&inverse, det, u, v, &res, &res_det),
+      CALCULATION_ERROR);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < k; j++) {
+      U.matrix[i][j] = i == 2 && j == 0;
+      V.matrix[i][j] = j == 0 ? v[i] : 0.0;
+    }
+  }
+  ck_assert_int_eq(s21_inverse_update(&inverse, det, &U, &V, &res, &res_det),
+                   CALCULATION_ERROR);
+  ck_assert_int_eq(s21_inverse_update(&inverse, det, &U, &Vt, &res, &res_det),
+                   CALCULATION_ERROR);
+
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&U);
+  s21_remove_matrix(&V);
+  s21_remove_matrix(&Vt);
+  s21_remove_matrix(&inverse);
+  ck_assert_int_eq(s21_inverse_update(&inverse, det, &U, &V, &res, &res_det),
+                   INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_pow_matrix) {
+  int n = 4;
+  matrix_t A = {0}, check = {0}, res = {0};
+  s21_create_matrix(n, n, &A);
+  s21_create_matrix(n, n, &check);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) A.matrix[i][j] = rand_float(-1, 1);
+    A.matrix[i][i] += n;
+    check.matrix[i][i] = 1.0;
+  }
+  for (int power = 0; power <= 11; power++) {
+    ck_assert_int_eq(s21_pow_matrix(&A, power, &res), OK);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        ck_assert_double_eq_tol(res.matrix[i][j], check.matrix[i][j],
+                                1e-9 * fabs(check.matrix[i][j]) + EPS);
+      }
+    }
+    s21_remove_matrix(&res);
+    matrix_t next = {0};
+    s21_mult_matrix(&check, &A, &next);
+    s21_remove_matrix(&check);
+    check = next;
+  }
+  s21_remove_matrix(&check);
+
+  matrix_t inverse = {0};
+  s21_inverse_matrix(&A, &inverse);
+  s21_mult_matrix(&inverse, &inverse, &check);
+  s21_remove_matrix(&inverse);
+  s21_mult_matrix(&check, &check, &inverse);
+  s21_mult_matrix(&inverse, &check, &res);
+  s21_remove_matrix(&check);
+  ck_assert_int_eq(s21_pow_matrix(&A, -6, &check), OK);
+  ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&inverse);
+  s21_remove_matrix(&res);
+
+  for (int j = 0; j < n; j++) A.matrix[1][j] = 0.0;
+  ck_assert_int_eq(s21_pow_matrix(&A, -1, &res), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_pow_matrix(&A, 3, &res), OK);
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&A);
+  ck_assert_int_eq(s21_pow_matrix(&A, 2, &res), INCORRECT_MATRIX);
+  s21_create_matrix(2, 3, &A);
+  ck_assert_int_eq(s21_pow_matrix(&A, 2, &res), CALCULATION_ERROR);
+  s21_remove_matrix(&A);
+}
+END_TEST
+
+START_TEST(test_s21_eq_matrix_tol) {
+  int rows = rand_int(), cols = rand_int();
+  matrix_t A = {0}, B = {0};
+  s21_create_matrix(rows, cols, &A);
+  s21_create_matrix(rows, cols, &B);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      A.matrix[i][j] = rand_float(1e6, 1e7);
+      B.matrix[i][j] = A.matrix[i][j];
+    }
+  }
+  ck_assert_int_eq(s21_eq_matrix(&A, &A), SUCCESS);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 0), SUCCESS);
+  B.matrix[rows - 1][cols - 1] = nextafter(A.matrix[rows - 1][cols - 1], 0);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 0), FAILURE);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 1), SUCCESS);
+  B.matrix[rows - 1][cols - 1] = A.matrix[rows - 1][cols - 1] * (1 + 1e-10);
+  ck_assert_int_eq(s21_eq_matrix(&A, &B), FAILURE);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, 1e-9), SUCCESS);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, 1e-11), FAILURE);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP + 1, 1), FAILURE);
+
+  unsigned long long hash_a = 0, hash_b = 0;
+  ck_assert_int_eq(s21_matrix_hash(&A, &hash_a), OK);
+  ck_assert_int_eq(s21_matrix_hash(&B, &hash_b), OK);
+  ck_assert_int_ne(hash_a, hash_b);
+  ck_assert_int_eq(s21_eq_matrix_hash(&A, &B), FAILURE);
+  B.matrix[rows - 1][cols - 1] = A.matrix[rows - 1][cols - 1];
+  ck_assert_int_eq(s21_matrix_hash(&B, &hash_b), OK);
+  ck_assert_int_eq(hash_a == hash_b, 1);
+  ck_assert_int_eq(s21_eq_matrix_hash(&A, &B), SUCCESS);
+  matrix_t C = {0};
+  s21_mult_number(&A, 1.0, &C);
+  ck_assert_int_eq(s21_eq_matrix_hash(&A, &C), SUCCESS);
+  C.matrix[0][0] += 1.0;
+  ck_assert_int_eq(s21_eq_matrix_hash(&A, &C), FAILURE);
+  double special[] = {0.0, NAN};
+  for (int t = 0; t < 2; t++) {
+    A.matrix[0][0] = special[t];
+    C.matrix[0][0] = t ? special[t] : -special[t];
+    A.hashed = C.hashed = 0;
+    int expected = t ? SUCCESS : FAILURE;
+    ck_assert_int_eq(s21_eq_matrix_hash(&A, &C), expected);
+    s21_matrix_hash(&A, &hash_a);
+    s21_matrix_hash(&C, &hash_b);
+    ck_assert_int_eq(s21_eq_matrix_hash(&A, &C), expected);
+  }
+  s21_remove_matrix(&C);
+
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&B);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &A, EQ_ABSOLUTE, EPS), FAILURE);
+  ck_assert_int_eq(s21_matrix_hash(&A, &hash_a), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_eq_matrix_hash(&A, &B), FAILURE);
+}
+END_TEST
+
+START_TEST(test_s21_eq_matrix_special) {
+  int cols = S21_EQ_BLOCK + 7;
+  matrix_t A = {0}, B = {0};
+  s21_create_matrix(2, cols, &A);
+  s21_create_matrix(2, cols, &B);
+  for (int j = 0; j < cols; j++) {
+    A.matrix[1][j] = B.matrix[1][j] = rand_float(-1, 1);
+  }
+  for (int j = 1; j < cols; j += S21_EQ_BLOCK - 1) {
+    A.matrix[1][j] = B.matrix[1][j] = INFINITY;
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ABSOLUTE, EPS), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, EPS), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 0), SUCCESS);
+    B.matrix[1][j] = -INFINITY;
+    ck_assert_int_eq(s21_eq_matrix(&A, &B), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ABSOLUTE, EPS), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, EPS), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 1), FAILURE);
+    A.matrix[1][j] = B.matrix[1][j] = NAN;
+    ck_assert_int_eq(s21_eq_matrix(&A, &B), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ABSOLUTE, EPS), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, EPS), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 1), FAILURE);
+    A.matrix[1][j] = B.matrix[1][j] = 0.0;
+  }
+  A.matrix[0][0] = 1e308;
+  B.matrix[0][0] = -1e308;
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ABSOLUTE, 1e300), FAILURE);
+  ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_RELATIVE, 2.5), SUCCESS);
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&B);
+}
+END_TEST
+
+START_TEST(test_s21_packed_matrix) {
+  int n = 6, m = 3;
+  int lower[] = {0, 5, 0, 5, 1}, upper[] = {5, 0, 0, 5, 2};
+  matrix_t B = {0};
+  s21_create_matrix(n, m, &B);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j++) B.matrix[i][j] = rand_float(-1, 1);
+  }
+  for (int structure = UPPER_TRIANGULAR; structure <= BANDED; structure++) {
+    matrix_t A = {0};
+    s21_create_matrix(n, n, &A);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        if (j - i <= upper[structure] && i - j <= lower[structure]) {
+          A.matrix[i][j] = rand_float(-1, 1);
+        }
+      }
+      A.matrix[i][i] += n;
+    }
+    if (structure == SYMMETRIC) {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < i; j++) A.matrix[j][i] = A.matrix[i][j];
+      }
+    }
+    packed_matrix_t P = {0};
+    ck_assert_int_eq(
+        s21_pack_matrix(&A, structure, lower[structure], upper[structure], &P),
+        OK);
+    matrix_t res = {0}, check = {0};
+    ck_assert_int_eq(s21_unpack_matrix(&P, &res), OK);
+    ck_assert_int_eq(s21_eq_matrix(&A, &res), SUCCESS);
+    s21_remove_matrix(&res);
+
+    ck_assert_int_eq(s21_packed_mult_matrix(&P, &B, &res), OK);
+    s21_mult_matrix(&A, &B, &check);
+    ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+    s21_remove_matrix(&res);
+    s21_remove_matrix(&check);
+
+    double det = 0.0, check_det = 0.0;
+    ck_assert_int_eq(s21_packed_determinant(&P, &det), OK);
+    s21_determinant(&A, &check_det);
+    ck_assert_double_eq_tol(det, check_det, 1e-9 * fabs(check_det));
+
+    ck_assert_int_eq(s21_packed_solve(&P, &B, &res), OK);
+    s21_mult_matrix(&A, &res, &check);
+    ck_assert_int_eq(s21_eq_matrix(&check, &B), SUCCESS);
+    s21_remove_matrix(&res);
+    s21_remove_matrix(&check);
+
+    packed_matrix_t inverse = {0};
+    if (structure == BANDED) {
+      ck_assert_int_eq(s21_packed_inverse(&P, &inverse), CALCULATION_ERROR);
+    } else {
+      ck_assert_int_eq(s21_packed_inverse(&P, &inverse), OK);
+      ck_assert_int_eq(inverse.structure, structure);
+      s21_unpack_matrix(&inverse, &res);
+      s21_inverse_matrix(&A, &check);
+      ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+      s21_remove_matrix(&res);
+      s21_remove_matrix(&check);
+      s21_remove_packed(&inverse);
+    }
+    if (structure != SYMMETRIC) {
+      ck_assert_ptr_null(s21_packed_at(&P, structure == UPPER_TRIANGULAR,
+                                       structure != UPPER_TRIANGULAR ? 5 : 0));
+    }
+    *s21_packed_at(&P, 0, 0) = 0.0;
+    if (structure < SYMMETRIC) {
+      ck_assert_int_eq(s21_packed_solve(&P, &B, &res), CALCULATION_ERROR);
+      ck_assert_int_eq(s21_packed_inverse(&P, &inverse), CALCULATION_ERROR);
+    }
+    s21_remove_packed(&P);
+    s21_remove_matrix(&A);
+    ck_assert_int_eq(s21_packed_determinant(&P, &det), INCORRECT_MATRIX);
+  }
+  s21_remove_matrix(&B);
+  packed_matrix_t P = {0};
+  for (int structure = UPPER_TRIANGULAR; structure <= BANDED; structure++) {
+    double det = 0.0;
+    ck_assert_int_eq(s21_create_packed(2, structure, 0, 0, &P), OK);
+    *s21_packed_at(&P, 0, 0) = 1.0;
+    *s21_packed_at(&P, 1, 1) = 1e-20;
+    ck_assert_int_eq(s21_packed_determinant(&P, &det), OK);
+    ck_assert_double_eq_tol(det, 1e-20, 1e-35);
+    if (structure < SYMMETRIC) {
+      packed_matrix_t inverse = {0};
+      matrix_t rhs = {0}, x = {0};
+      s21_create_matrix(2, 1, &rhs);
+      rhs.matrix[0][0] = 1.0;
+      rhs.matrix[1][0] = 1e-20;
+      ck_assert_int_eq(s21_packed_solve(&P, &rhs, &x), OK);
+      ck_assert_double_eq_tol(x.matrix[1][0], 1.0, EPS);
+      ck_assert_int_eq(s21_packed_inverse(&P, &inverse), OK);
+      ck_assert_double_eq_tol(*s21_packed_at(&inverse, 1, 1) / 1e20, 1, EPS);
+      s21_remove_matrix(&rhs);
+      s21_remove_matrix(&x);
+      s21_remove_packed(&inverse);
+    }
+    s21_remove_packed(&P);
+  }
+  ck_assert_int_eq(s21_create_packed(0, DIAGONAL, 0, 0, &P), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_create_packed(3, BANDED, -1, 0, &P), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_async) {
+  int n = 120;
+  matrix_t A = {0}, B = {0}, small = {0};
+  s21_create_matrix(n, n, &A);
+  s21_create_matrix(n, n, &B);
+  s21_create_matrix(3, 3, &small);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      A.matrix[i][j] = rand_float(-1, 1);
+      B.matrix[i][j] = rand_float(-1, 1);
+    }
+  }
+  double val[] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  for (int i = 0; i < 9; i++) small.matrix[i / 3][i % 3] = val[i];
+
+  matrix_t mult = {0}, transpose = {0}, inverse = {0}, bad = {0};
+  double det = 0.0;
+  s21_future_t *futures[5] = {NULL};
+  ck_assert_int_eq(s21_mult_matrix_async(&A, &B, &mult, &futures[0]), OK);
+  ck_assert_int_eq(s21_transpose_async(&A, &transpose, &futures[1]), OK);
+  ck_assert_int_eq(s21_inverse_matrix_async(&small, &inverse, &futures[2]),
+                   OK);
+  ck_assert_int_eq(s21_determinant_async(&small, &det, &futures[3]), OK);
+  ck_assert_int_eq(s21_mult_matrix_async(&A, &small, &bad, &futures[4]), OK);
+  ck_assert_int_eq(s21_mult_matrix_async(&A, &B, &bad, NULL),
+                   INCORRECT_MATRIX);
+
+  ck_assert_int_eq(s21_future_wait(futures[0]), OK);
+  ck_assert_int_eq(s21_future_wait(futures[1]), OK);
+  ck_assert_int_eq(s21_future_wait(futures[2]), OK);
+  while (s21_future_ready(futures[3]) == FAILURE) {
+  }
+  ck_assert_int_eq(s21_future_wait(futures[3]), OK);
+  ck_assert_int_eq(s21_future_wait(futures[4]), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_future_wait(NULL), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_future_ready(NULL), FAILURE);
+
+  matrix_t check = {0};
+  s21_mult_matrix(&A, &B, &check);
+  ck_assert_int_eq(s21_eq_matrix(&check, &mult), SUCCESS);
+  s21_remove_matrix(&check);
+  s21_transpose(&A, &check);
+  ck_assert_int_eq(s21_eq_matrix(&check, &transpose), SUCCESS);
+  s21_remove_matrix(&check);
+  s21_inverse_matrix(&small, &check);
+  ck_assert_int_eq(s21_eq_matrix(&check, &inverse), SUCCESS);
+  ck_assert_double_eq_tol(det, -1.0, EPS);
+
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&mult);
+  s21_remove_matrix(&transpose);
+  s21_remove_matrix(&inverse);
+  s21_remove_matrix(&A);
+  s21_remove_matrix(&B);
+  s21_remove_matrix(&small);
+  s21_scheduler_shutdown();
+}
+END_TEST
+
+START_TEST(test_s21_load_matrix) {
+  const char *path = "s21_matrix_test.mtx";
+  FILE *file = fopen(path, "w");
+  fputs("# comment\n1, 2.5 ,-3e2\n\n4\t5.000000000000000000001;6\r\n", file);
+  fclose(file);
+  matrix_t A = {0};
+  ck_assert_int_eq(s21_load_matrix(path, &A), OK);
+  ck_assert_int_eq(A.rows, 2);
+  ck_assert_int_eq(A.columns, 3);
+  ck_assert_double_eq_tol(A.matrix[0][1], 2.5, EPS);
+  ck_assert_double_eq_tol(A.matrix[0][2], -300, EPS);
+  ck_assert_double_eq_tol(A.matrix[1][1], 5, EPS);
+  s21_remove_matrix(&A);
+
+  file = fopen(path, "w");
+  fputs("%%MatrixMarket matrix coordinate real symmetric\n% comment\n"
+        "3 3 2\n2 1 -1.5\n3 3 7\n", file);
+  fclose(file);
+  ck_assert_int_eq(s21_load_matrix(path, &A), OK);
+  ck_assert_double_eq_tol(A.matrix[0][1], -1.5, EPS);
+  ck_assert_double_eq_tol(A.matrix[1][0], -1.5, EPS);
+  ck_assert_double_eq_tol(A.matrix[2][2], 7, EPS);
+  ck_assert_double_eq_tol(A.matrix[0][0], 0, EPS);
+  s21_remove_matrix(&A);
+
+  const char *broken[] = {"1 2\n3\n", "1 x\n", "",
+                          "%%MatrixMarket matrix array real general\n2 2\n1\n",
+                          "%%MatrixMarket matrix coordinate real general\n"
+                          "2 2 1\n3 1 1\n",
+                          "%%MatrixMarket matrix coordinate real general\n"
+                          "2 2 1\n1e20 1 3\n",
+                          "%%MatrixMarket matrix coordinate real general\n"
+                          "2 2 1\n1 -4e9 3\n"};
+  for (int k = 0; k < 7; k++) {
+    file = fopen(path, "w");
+    fputs(broken[k], file);
+    fclose(file);
+    ck_assert_int_eq(s21_load_matrix(path, &A), INCORRECT_MATRIX);
+  }
+  remove(path);
+  ck_assert_int_eq(s21_load_matrix(path, &A), INCORRECT_MATRIX);
+}
+END_TEST
+
+START_TEST(test_s21_save_matrix) {
+  const char *path = "s21_matrix_test.mtx";
+  int sizes[][2] = {{rand_int(), rand_int()}, {400, 600}};
+  for (int t = 0; t < 2; t++) {
+    matrix_t A = {0}, B = {0};
+    s21_create_matrix(sizes[t][0], sizes[t][1], &A);
+    for (int i = 0; i < A.rows; i++) {
+      for (int j = 0; j < A.columns; j++) {
+        A.matrix[i][j] = rand_float(-1e10, 1e10) / (j + 1);
+      }
+    }
+    for (int format = FORMAT_CSV; format <= FORMAT_MATRIX_MARKET; format++) {
+      ck_assert_int_eq(s21_save_matrix(path, &A, format), OK);
+      ck_assert_int_eq(s21_load_matrix(path, &B), OK);
+      ck_assert_int_eq(s21_eq_matrix_tol(&A, &B, EQ_ULP, 0), SUCCESS);
+      s21_remove_matrix(&B);
+    }
+    ck_assert_int_eq(s21_save_matrix(path, &A, FORMAT_MATRIX_MARKET + 1),
+                     INCORRECT_MATRIX);
+    s21_remove_matrix(&A);
+    ck_assert_int_eq(s21_save_matrix(path, &A, FORMAT_CSV), INCORRECT_MATRIX);
+  }
+  remove(path);
+}
+END_TEST
+
+START_TEST(test_s21_set_alloc_mode) {
+  int rows = 600, cols = 600;
+  matrix_t A = {0}, B = {0}, res = {0}, check = {0};
+  ck_assert_int_eq(s21_set_alloc_mode(ALLOC_HUGE_PAGES + 1), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_set_alloc_mode(ALLOC_HUGE_PAGES), OK);
+  ck_assert_int_eq(s21_create_matrix(rows, cols, &A), OK);
+  ck_assert_ptr_nonnull(A.block);
+  s21_create_matrix(10, 10, &B);
+  ck_assert_ptr_null(B.block);
+  s21_remove_matrix(&B);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      ck_assert_double_eq_tol(A.matrix[i][j], 0, EPS);
+      A.matrix[i][j] = rand_float(-1, 1);
+    }
+  }
+  ck_assert_int_eq(s21_mult_number(&A, 2.0, &res), OK);
+  ck_assert_ptr_nonnull(res.block);
+
+  ck_assert_int_eq(s21_set_alloc_mode(ALLOC_DEFAULT), OK);
+  s21_create_matrix(rows, cols, &B);
+  ck_assert_ptr_null(B.block);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) B.matrix[i][j] = A.matrix[i][j];
+  }
+  s21_sum_matrix(&A, &B, &check);
+  ck_assert_int_eq(s21_eq_matrix(&check, &res), SUCCESS);
+
+  s21_remove_matrix(&A);
+  ck_assert_ptr_null(A.block);
+  s21_remove_matrix(&B);
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&check);
+}
+END_TEST
+
+START_TEST(test_s21_reductions) {
+  int sizes[][2] = {{rand_int(), rand_int()}, {700, 500}};
+  for (int t = 0; t < 2; t++) {
+    int rows = sizes[t][0], cols = sizes[t][1];
+    matrix_t A = {0};
+    s21_create_matrix(rows, cols, &A);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) A.matrix[i][j] = rand_float(-10, 10);
+    }
+    A.matrix[rows / 2][cols / 2] = -20;
+    A.matrix[rows - 1][cols - 1] = 30;
+
+    double sum = 0.0, squares = 0.0, norm_inf = 0.0, norm_one = 0.0;
+    for (int i = 0; i < rows; i++) {
+      double row_sum = 0.0;
+      for (int j = 0; j < cols; j++) {
+        sum += A.matrix[i][j];
+        squares += A.matrix[i][j] * A.matrix[i][j];
+        row_sum += fabs(A.matrix[i][j]);
+      }
+      norm_inf = fmax(norm_inf, row_sum);
+    }
+    for (int j = 0; j < cols; j++) {
+      double col_sum = 0.0;
+      for (int i = 0; i < rows; i++) col_sum += fabs(A.matrix[i][j]);
+      norm_one = fmax(norm_one, col_sum);
+    }
+
+    double res = 0.0, again = 0.0, min = 0.0, max = 0.0;
+    ck_assert_int_eq(s21_sum_elements(&A, &res), OK);
+    ck_assert_double_eq_tol(res, sum, 1e-8);
+    ck_assert_int_eq(s21_sum_elements(&A, &again), OK);
+    ck_assert_double_eq(res, again);
+    ck_assert_int_eq(s21_norm_frobenius(&A, &res), OK);
+    ck_assert_double_eq_tol(res, sqrt(squares), 1e-8);
+    ck_assert_int_eq(s21_norm_inf(&A, &res), OK);
+    ck_assert_double_eq_tol(res, norm_inf, 1e-8);
+    ck_assert_int_eq(s21_norm_one(&A, &res), OK);
+    ck_assert_double_eq_tol(res, norm_one, 1e-8);
+    ck_assert_int_eq(s21_min_max(&A, &min, &max), OK);
+    ck_assert_double_eq_tol(min, -20, EPS);
+    ck_assert_double_eq_tol(max, 30, EPS);
+    ck_assert_int_eq(s21_trace(&A, &res), rows == cols ? OK
+                                                       : CALCULATION_ERROR);
+    A.matrix[rows - 1][0] = NAN;
+    ck_assert_int_eq(s21_norm_inf(&A, &res), OK);
+    ck_assert_int_eq(isnan(res) != 0, 1);
+    ck_assert_int_eq(s21_norm_one(&A, &res), OK);
+    ck_assert_int_eq(isnan(res) != 0, 1);
+    ck_assert_int_eq(s21_min_max(&A, &min, &max), OK);
+    ck_assert_int_eq(isnan(min) && isnan(max), 1);
+    s21_remove_matrix(&A);
+    ck_assert_int_eq(s21_sum_elements(&A, &res), INCORRECT_MATRIX);
+    ck_assert_int_eq(s21_norm_one(&A, &res), INCORRECT_MATRIX);
+    ck_assert_int_eq(s21_min_max(&A, &min, &max), INCORRECT_MATRIX);
+  }
+  matrix_t A = {0};
+  s21_create_matrix(3, 3, &A);
+  for (int i = 0; i < 9; i++) A.matrix[i / 3][i % 3] = i;
+  double trace = 0.0;
+  ck_assert_int_eq(s21_trace(&A, &trace), OK);
+  ck_assert_double_eq_tol(trace, 12, EPS);
+  int nan_at[][2] = {{0, 0}, {1, 1}, {2, 2}};
+  for (int t = 0; t < 3; t++) {
+    for (int i = 0; i < 9; i++) A.matrix[i / 3][i % 3] = i;
+    A.matrix[nan_at[t][0]][nan_at[t][1]] = NAN;
+    double min = 0.0, max = 0.0;
+    ck_assert_int_eq(s21_norm_inf(&A, &trace), OK);
+    ck_assert_int_eq(isnan(trace) != 0, 1);
+    ck_assert_int_eq(s21_norm_one(&A, &trace), OK);
+    ck_assert_int_eq(isnan(trace) != 0, 1);
+    ck_assert_int_eq(s21_min_max(&A, &min, &max), OK);
+    ck_assert_int_eq(isnan(min) && isnan(max), 1);
+  }
+  double scales[] = {1e200, 1e-200}, norm = 0.0;
+  for (int t = 0; t < 2; t++) {
+    for (int i = 0; i < 9; i++) A.matrix[i / 3][i % 3] = i * scales[t];
+    ck_assert_int_eq(s21_norm_frobenius(&A, &norm), OK);
+    ck_assert_double_eq_tol(norm / scales[t], sqrt(204), EPS);
+  }
+  s21_remove_matrix(&A);
+  ck_assert_int_eq(s21_trace(&A, &trace), INCORRECT_MATRIX);
+}
+END_TEST
+
 Suite *s21_matrix_suite(void) {
   Suite *suite;
   TCase *core;
@@ -490,7 +1288,10 @@ Suite *s21_matrix_suite(void) {
 
   tcase_add_test(core, test_s21_create_matrix);
   tcase_add_test(core, test_s21_remove_matrix);
+  tcase_add_test(core, test_s21_set_alloc_mode);
   tcase_add_test(core, test_s21_eq_matrix);
+  tcase_add_test(core, test_s21_eq_matrix_tol);
+  tcase_add_test(core, test_s21_eq_matrix_special);
   tcase_add_test(core, test_s21_sum_matrix);
   tcase_add_test(core, test_s21_sub_matrix);
   tcase_add_test(core, test_s21_mult_number);
@@ -498,7 +1299,20 @@ Suite *s21_matrix_suite(void) {
   tcase_add_test(core, test_s21_transpose);
   tcase_add_test(core, test_s21_calc_complements);
   tcase_add_test(core, test_s21_determinant);
+  tcase_add_test(core, test_s21_determinant_large);
   tcase_add_test(core, test_s21_inverse_matrix);
+  tcase_add_test(core, test_s21_mult_vector);
+  tcase_add_test(core, test_s21_dot);
+  tcase_add_test(core, test_s21_matrix_f);
+  tcase_add_test(core, test_s21_determinant_f);
+  tcase_add_test(core, test_s21_solve_mixed);
+  tcase_add_test(core, test_s21_inverse_update);
+  tcase_add_test(core, test_s21_pow_matrix);
+  tcase_add_test(core, test_s21_packed_matrix);
+  tcase_add_test(core, test_s21_async);
+  tcase_add_test(core, test_s21_load_matrix);
+  tcase_add_test(core, test_s21_save_matrix);
+  tcase_add_test(core, test_s21_reductions);
 
   suite_add_tcase(suite, core);
 